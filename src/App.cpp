@@ -1,5 +1,6 @@
 #include "App.hpp"
 #include "Constants.hpp"
+#include "Tracer.hpp"
 
 #include <array>
 #include <filesystem>
@@ -33,8 +34,15 @@ App::App()
     if (!sf::Shader::isAvailable())
         throw std::runtime_error("Shaders are not available");
 
+    if (!m_gallery.create())
+        throw std::runtime_error("Unable to create gallery atlas");
+
+    if (!m_comparison.create())
+        throw std::runtime_error("Unable to compile A/B difference shader");
+
     m_shaderSource.resize(constants::SOURCE_STRING_CHAR_COUNT);
     m_errorQueue.resize(static_cast<std::size_t>(ErrorMessageType::MAX));
+    m_galleryDirectory.resize(300);
 }
 
 App::~App() { ImGui::SFML::Shutdown(m_window); }
@@ -43,66 +51,126 @@ void App::run()
 {
     sf::Clock loopClock;
     sf::Clock elapsedClock;
+    trace::setThreadName("Main");
     while (m_window.isOpen()) {
         // spdlog::debug("Has focus? {}", m_window.hasFocus());
         auto dt = loopClock.restart();
+        checkForHitch(dt);
         if (dt > sf::seconds(0.25f)) {
             dt = sf::seconds(0.25f);
         }
 
-        sf::Event event;
-        while (m_window.pollEvent(event)) {
-            ImGui::SFML::ProcessEvent(m_window, event);
-            if (event.type == sf::Event::Closed)
-                m_window.close();
-
-            if (event.type == sf::Event::Resized) {
-                const sf::View v { sf::Vector2f { static_cast<float>(event.size.width) / 2.0f,
-                                                  static_cast<float>(event.size.height) / 2.0f },
-                                   sf::Vector2f { static_cast<float>(event.size.width),
-                                                  static_cast<float>(event.size.height) } };
-                m_window.setView(v);
-            };
-        }
+        // Scoped so the frame span is recorded before collect() below
+        {
+            TRACE_SCOPE("Frame");
+            {
+                TRACE_SCOPE("Events");
+                sf::Event event;
+                while (m_window.pollEvent(event)) {
+                    ImGui::SFML::ProcessEvent(m_window, event);
+                    if (event.type == sf::Event::Closed)
+                        m_window.close();
+
+                    if (event.type == sf::Event::Resized) {
+                        const sf::View v { sf::Vector2f { static_cast<float>(event.size.width) / 2.0f,
+                                                          static_cast<float>(event.size.height) / 2.0f },
+                                           sf::Vector2f { static_cast<float>(event.size.width),
+                                                          static_cast<float>(event.size.height) } };
+                        m_window.setView(v);
+                    };
+                }
+            }
+
+            logFPS(dt);
+            {
+                TRACE_SCOPE("App::updateUI");
+                updateUI(dt);
+            }
+
+            auto& uniforms = m_shaderMgr.getUniforms();
+            const auto renderTextureSize = sf::Vector2f { m_renderTexture.getSize() };
+
+            uniforms.elapsedTime = elapsedClock.getElapsedTime();
+            uniforms.deltaTime = dt;
+            uniforms.resolution = renderTextureSize;
+
+            uniforms.mousePos = sf::Vector2f { sf::Mouse::getPosition(m_window) };
+            const auto subtractAmount
+                = sf::Vector2f { m_window.getView().getCenter().x - static_cast<float>(renderTextureSize.x) / 2.f,
+                                 m_window.getView().getCenter().y - static_cast<float>(renderTextureSize.y) / 2.f };
+            uniforms.mousePos -= subtractAmount;
+            uniforms.mousePos.x = std::clamp(uniforms.mousePos.x, 0.0f, renderTextureSize.x);
+            uniforms.mousePos.y = std::clamp(uniforms.mousePos.y, 0.0f, renderTextureSize.y);
+            uniforms.mousePos.y = renderTextureSize.y - uniforms.mousePos.y;
+            uniforms.frames = m_frames;
+
+            {
+                TRACE_SCOPE("TextureManager::update");
+                m_textureMgr.update(m_frames);
+            }
+            m_shaderMgr.update(m_useShaderToyNames, m_textureMgr);
+            {
+                TRACE_SCOPE("ShaderGallery::update");
+                m_gallery.update(uniforms, m_textureMgr);
+            }
+
+            {
+                TRACE_SCOPE("Render shader");
+                m_renderTexture.clear();
+                sf::RectangleShape shape(sf::Vector2f { m_renderTexture.getSize() });
+                shape.setTextureRect({ { 0, 0 }, sf::Vector2i { shape.getSize() } });
+                m_renderTexture.draw(shape, &m_shaderMgr.getShader());
+                m_renderTexture.display();
+            }
+
+            if (m_comparisonEnabled)
+                m_comparison.update(uniforms, m_textureMgr);
+
+            {
+                TRACE_SCOPE("Render window");
+                m_window.clear(sf::Color(75, 75, 75));
+                sf::Sprite spr(m_renderTexture.getTexture());
+                spr.setPosition((sf::Vector2f(m_window.getSize()) * 0.5f) - (spr.getGlobalBounds().getSize() * 0.5f));
+                m_window.draw(spr);
+                ImGui::SFML::Render(m_window);
+            }
 
-        logFPS(dt);
-        updateUI(dt);
-
-        auto& uniforms = m_shaderMgr.getUniforms();
-        const auto renderTextureSize = sf::Vector2f { m_renderTexture.getSize() };
-
-        uniforms.elapsedTime = elapsedClock.getElapsedTime();
-        uniforms.deltaTime = dt;
-        uniforms.resolution = renderTextureSize;
-
-        uniforms.mousePos = sf::Vector2f { sf::Mouse::getPosition(m_window) };
-        const auto subtractAmount
-            = sf::Vector2f { m_window.getView().getCenter().x - static_cast<float>(renderTextureSize.x) / 2.f,
-                             m_window.getView().getCenter().y - static_cast<float>(renderTextureSize.y) / 2.f };
-        uniforms.mousePos -= subtractAmount;
-        uniforms.mousePos.x = std::clamp(uniforms.mousePos.x, 0.0f, renderTextureSize.x);
-        uniforms.mousePos.y = std::clamp(uniforms.mousePos.y, 0.0f, renderTextureSize.y);
-        uniforms.mousePos.y = renderTextureSize.y - uniforms.mousePos.y;
-        uniforms.frames = m_frames;
-
-        m_shaderMgr.update(m_useShaderToyNames, m_textureMgr);
-
-        m_renderTexture.clear();
-        sf::RectangleShape shape(sf::Vector2f { m_renderTexture.getSize() });
-        shape.setTextureRect({ { 0, 0 }, sf::Vector2i { shape.getSize() } });
-        m_renderTexture.draw(shape, &m_shaderMgr.getShader());
-        m_renderTexture.display();
-
-        m_window.clear(sf::Color(75, 75, 75));
-        sf::Sprite spr(m_renderTexture.getTexture());
-        spr.setPosition((sf::Vector2f(m_window.getSize()) * 0.5f) - (spr.getGlobalBounds().getSize() * 0.5f));
-        m_window.draw(spr);
-        ImGui::SFML::Render(m_window);
-        m_window.display();
-        ++m_frames;
+            {
+                // Mostly time spent blocked on vsync/the frame limit
+                TRACE_SCOPE("RenderWindow::display");
+                m_window.display();
+            }
+            ++m_frames;
+        }
+        trace::collect();
     }
 }
 
+void App::checkForHitch(const sf::Time& dt)
+{
+    constexpr auto HITCH_DUMP_COOLDOWN { 5.f };
+    if (!trace::isEnabled() || m_hitchThresholdMs <= 0.f || dt.asSeconds() * 1000.f < m_hitchThresholdMs)
+        return;
+
+    // A run of slow frames is one hitch as far as we're concerned
+    if (m_hitchDumpClock.getElapsedTime().asSeconds() < HITCH_DUMP_COOLDOWN)
+        return;
+
+    m_hitchDumpClock.restart();
+    spdlog::warn("Frame took {}ms", dt.asMilliseconds());
+    dumpTrace();
+}
+
+void App::dumpTrace()
+{
+    const auto path = fmt::format("trace-{}.json", m_frames);
+    const auto result = trace::dump(path);
+    if (result)
+        spdlog::error("{}", result.value());
+    else
+        spdlog::info("Wrote trace to {}", path);
+}
+
 void App::logFPS(const sf::Time& dt)
 {
     static int counter = 0;
@@ -126,7 +194,10 @@ void App::updateUI(const sf::Time& dt)
     constexpr auto BOTTOM_PANEL_WINDOW_WIDTH_PERCENT { 1.f - (1.f * SIDE_PANEL_WINDOW_WIDTH_PERCENT) };
     constexpr auto BOTTOM_PANEL_WINDOW_HEIGHT_PERCENT { 0.15f };
 
-    ImGui::SFML::Update(m_window, dt);
+    {
+        TRACE_SCOPE("ImGui::SFML::Update");
+        ImGui::SFML::Update(m_window, dt);
+    }
     const auto renderWindowSize = sf::Vector2f { m_window.getSize() };
     const auto sidePanelSize
         = sf::Vector2f { renderWindowSize.x * SIDE_PANEL_WINDOW_WIDTH_PERCENT, renderWindowSize.y };
@@ -163,6 +234,8 @@ void App::updateUI(const sf::Time& dt)
         }
     }
 
+    ImGui::Checkbox("A/B Compare", &m_comparisonEnabled);
+
     ImGui::Text("In built variables");
     if (!m_useShaderToyNames) {
         ImGui::Text("u_deltaTime = Delta Time");
@@ -194,6 +267,19 @@ void App::updateUI(const sf::Time& dt)
     }
     ImGui::Separator();
 
+    /*
+    Profiling
+    */
+    ImGui::Text("Profiling");
+    if (ImGui::Checkbox("Record Trace", &m_traceEnabled))
+        trace::setEnabled(m_traceEnabled);
+
+    ImGui::Text("Hitch Threshold (ms)");
+    ImGui::InputFloat("##hitchThreshold", &m_hitchThresholdMs, 1.f, 10.f, "%.1f");
+    if (ImGui::Button("Dump Trace"))
+        dumpTrace();
+    ImGui::Separator();
+
     /*
     Texture channels for shader
     */
@@ -290,6 +376,11 @@ void App::updateUI(const sf::Time& dt)
     }
     ImGui::End();
 
+    updateGalleryUI(sidePanelSize);
+
+    if (m_comparisonEnabled)
+        m_comparison.drawUI(m_shaderSource.c_str(), m_useShaderToyNames);
+
     /*
     Export Window
     (Still deciding on preferred layout..)
@@ -301,29 +392,69 @@ void App::updateUI(const sf::Time& dt)
     // ImGui::End();
 }
 
-void App::loadExampleShader(ExampleShaders exampleShader)
+void App::updateGalleryUI(const sf::Vector2f& panelSize)
 {
-    m_shaderSource.clear();
+    /*
+    Gallery Window
+    */
+    const auto renderWindowSize = sf::Vector2f { m_window.getSize() };
+    if (!ImGui::Begin("Gallery", NULL, ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove)) {
+        ImGui::End();
+        return;
+    }
+    ImGui::SetWindowSize(panelSize);
+    ImGui::SetWindowPos({ renderWindowSize.x - panelSize.x, 0 });
 
+    ImGui::PushItemWidth(ImGui::GetWindowWidth() * 0.95f);
+    ImGui::Text("Shader Directory");
+    ImGui::InputText("##galleryDirectory", m_galleryDirectory.data(), m_galleryDirectory.size());
+    ImGui::PopItemWidth();
+
+    if (ImGui::Button("Scan") && m_galleryDirectory[0] != '\0')
+        m_gallery.scanDirectory(m_galleryDirectory.c_str());
+
+    ImGui::SameLine();
+    if (m_gallery.isScanning())
+        ImGui::Text("Loading... (%zu)", m_gallery.getEntryCount());
+    else
+        ImGui::Text("%zu shaders", m_gallery.getEntryCount());
+
+    if (const auto error = m_gallery.getScanError())
+        ImGui::TextColored(ImVec4(sf::Color::Red), "%s", error->data());
+    ImGui::Separator();
+
+    ImGui::BeginChild("##thumbnails");
+    if (const auto* clicked = m_gallery.drawUI())
+        loadShaderSource(clicked->source, clicked->useShadertoy);
+    ImGui::EndChild();
+    ImGui::End();
+}
+
+void App::loadExampleShader(ExampleShaders exampleShader)
+{
     switch (exampleShader) {
     case ExampleShaders::Basic:
-        m_shaderSource = BASIC_SHADER_SOURCE;
+        loadShaderSource(BASIC_SHADER_SOURCE, false);
         break;
     case ExampleShaders::Generic_Noise:
-        m_shaderSource = GENERIC_NOISE_SOURCE;
+        loadShaderSource(GENERIC_NOISE_SOURCE, false);
         break;
     case ExampleShaders::Simplex_Noise:
-        m_shaderSource = SIMPLEX_SHADER_SOURCE;
+        loadShaderSource(SIMPLEX_SHADER_SOURCE, false);
         break;
     case ExampleShaders::TextureBackground:
-        m_shaderSource = TEXTURE_BACKGROUND_SOURCE;
+        loadShaderSource(TEXTURE_BACKGROUND_SOURCE, false);
         break;
     default:
         assert(false);
     }
+}
 
+void App::loadShaderSource(std::string_view source, bool useShadertoy)
+{
+    m_shaderSource = source;
     m_shaderSource.resize(constants::SOURCE_STRING_CHAR_COUNT);
-    m_useShaderToyNames = false;
+    m_useShaderToyNames = useShadertoy;
     const auto result = m_shaderMgr.loadAndCompile(m_shaderSource, m_useShaderToyNames);
     if (result) {
         m_errorQueue[static_cast<std::size_t>(ErrorMessageType::Shader)] = result.value();
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "ExampleShaders.hpp"
+#include "ShaderComparison.hpp"
+#include "ShaderGallery.hpp"
 #include "ShaderManager.hpp"
 #include "TextureManager.hpp"
 
@@ -27,14 +29,33 @@ private:
     // active shader
     void loadExampleShader(ExampleShaders exampleShader);
 
+    // Replace the editor contents with the source & compile it
+    void loadShaderSource(std::string_view source, bool useShadertoy);
+
+    // Handles the gallery window
+    void updateGalleryUI(const sf::Vector2f& panelSize);
+
+    // Dumps the trace if the last frame went over the hitch threshold
+    void checkForHitch(const sf::Time& dt);
+
+    // Writes the recorded trace spans to trace-<frame>.json
+    void dumpTrace();
+
     sf::RenderWindow m_window;
     sf::RenderTexture m_renderTexture;
     ShaderManager m_shaderMgr;
     TextureManager m_textureMgr;
+    ShaderGallery m_gallery;
+    ShaderComparison m_comparison;
     std::string m_shaderSource;
+    std::string m_galleryDirectory;
     std::vector<std::string> m_errorQueue;
+    sf::Clock m_hitchDumpClock;
 
     bool m_failedToMakeRenderTexture { false };
     bool m_useShaderToyNames { false };
+    bool m_traceEnabled { false };
+    bool m_comparisonEnabled { false };
+    float m_hitchThresholdMs { 50.f };
     std::int32_t m_frames { 0 };
 };
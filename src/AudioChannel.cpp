@@ -0,0 +1,283 @@
+#include "AudioChannel.hpp"
+#include "ErrorCapture.hpp"
+#include "TripleBuffer.hpp"
+
+#include <SFML/Audio/InputSoundFile.hpp>
+#include <SFML/Audio/SoundRecorder.hpp>
+#include <SFML/Audio/SoundStream.hpp>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <spdlog/fmt/fmt.h>
+#include <vector>
+
+namespace {
+constexpr std::array AUDIO_EXTENSIONS { ".ogg", ".wav", ".flac", ".mp3" };
+constexpr std::string_view MIC_PREFIX { "mic" };
+constexpr std::size_t STREAM_CHUNK_FRAMES { 512 };
+constexpr unsigned CAPTURE_SAMPLE_RATE { 44100 };
+
+// Same mapping as the WebAudio analyser Shadertoy is built on
+constexpr float MIN_DECIBELS { -100.f };
+constexpr float MAX_DECIBELS { -30.f };
+constexpr float SMOOTHING { 0.8f };
+
+constexpr float PI { 3.14159265358979f };
+
+bool isCapturePath(std::string_view path)
+{
+    return path == MIC_PREFIX || path.substr(0, MIC_PREFIX.size() + 1) == "mic:";
+}
+
+// One block of radix-2 butterflies. The two halves of a block never
+// overlap, and saying so lets the compiler vectorise this without
+// versioning it behind a runtime aliasing check
+void butterflies(float* __restrict aRe,
+                 float* __restrict aIm,
+                 float* __restrict bRe,
+                 float* __restrict bIm,
+                 const float* __restrict wr,
+                 const float* __restrict wi,
+                 std::size_t half)
+{
+    for (std::size_t j = 0; j < half; ++j) {
+        const auto tRe = wr[j] * bRe[j] - wi[j] * bIm[j];
+        const auto tIm = wr[j] * bIm[j] + wi[j] * bRe[j];
+        bRe[j] = aRe[j] - tRe;
+        bIm[j] = aIm[j] - tIm;
+        aRe[j] += tRe;
+        aIm[j] += tIm;
+    }
+}
+}
+
+// Turns blocks of interleaved samples into spectrum & waveform rows. Runs
+// on the audio thread, so everything it touches is allocated up front.
+class AudioChannel::Analyser {
+public:
+    Analyser()
+    {
+        for (std::size_t i = 0; i < FFT_SIZE; ++i) {
+            m_window[i] = 0.5f - 0.5f * std::cos(2.f * PI * static_cast<float>(i) / static_cast<float>(FFT_SIZE));
+
+            std::size_t reversed = 0;
+            for (std::size_t bit = 1, mirrored = FFT_SIZE >> 1; bit < FFT_SIZE; bit <<= 1, mirrored >>= 1) {
+                if (i & bit)
+                    reversed |= mirrored;
+            }
+            m_bitReverse[i] = reversed;
+        }
+
+        // Each stage's twiddles are stored contiguously (stage with
+        // half size h starts at h - 1) so the butterflies vectorise
+        for (std::size_t half = 1; half < FFT_SIZE; half <<= 1) {
+            for (std::size_t j = 0; j < half; ++j) {
+                const auto angle = -PI * static_cast<float>(j) / static_cast<float>(half);
+                m_twiddleRe[half - 1 + j] = std::cos(angle);
+                m_twiddleIm[half - 1 + j] = std::sin(angle);
+            }
+        }
+    }
+
+    void process(const std::int16_t* samples, std::size_t sampleCount, unsigned channelCount)
+    {
+        if (channelCount == 0)
+            return;
+
+        // Downmix into the history ring
+        const auto frameCount = sampleCount / channelCount;
+        for (std::size_t frame = 0; frame < frameCount; ++frame) {
+            int sum = 0;
+            for (std::size_t channel = 0; channel < channelCount; ++channel)
+                sum += samples[frame * channelCount + channel];
+
+            m_history[m_historyIndex] = static_cast<float>(sum) / (32768.f * static_cast<float>(channelCount));
+            m_historyIndex = (m_historyIndex + 1) % FFT_SIZE;
+        }
+
+        if (frameCount == 0)
+            return;
+
+        // Analysis goes straight into the hand-off slot, and a render
+        // thread that's fallen behind only ever sees the newest block
+        analyse();
+        m_frames.publish();
+    }
+
+    // Render thread side
+    bool pop(Frame& frame) { return m_frames.tryRead(frame); }
+
+private:
+    void analyse()
+    {
+        for (std::size_t i = 0; i < FFT_SIZE; ++i) {
+            const auto sample = m_history[(m_historyIndex + i) % FFT_SIZE];
+            m_re[m_bitReverse[i]] = sample * m_window[i];
+            m_im[m_bitReverse[i]] = 0.f;
+        }
+
+        for (std::size_t half = 1; half < FFT_SIZE; half <<= 1) {
+            const auto* wr = &m_twiddleRe[half - 1];
+            const auto* wi = &m_twiddleIm[half - 1];
+            for (std::size_t block = 0; block < FFT_SIZE; block += half * 2)
+                butterflies(&m_re[block], &m_im[block], &m_re[block + half], &m_im[block + half], wr, wi, half);
+        }
+
+        const auto scale = 1.f / static_cast<float>(FFT_SIZE);
+        for (std::size_t bin = 0; bin < BIN_COUNT; ++bin) {
+            const auto magnitude = std::sqrt(m_re[bin] * m_re[bin] + m_im[bin] * m_im[bin]) * scale;
+            m_smoothed[bin] = SMOOTHING * m_smoothed[bin] + (1.f - SMOOTHING) * magnitude;
+        }
+
+        for (std::size_t bin = 0; bin < BIN_COUNT; ++bin) {
+            const auto decibels = 20.f * std::log10(std::max(m_smoothed[bin], 1e-12f));
+            const auto level = std::clamp((decibels - MIN_DECIBELS) / (MAX_DECIBELS - MIN_DECIBELS), 0.f, 1.f);
+            writePixel(bin, static_cast<std::uint8_t>(level * 255.f));
+        }
+
+        // The waveform row is the newest half of the history
+        for (std::size_t i = 0; i < BIN_COUNT; ++i) {
+            const auto sample = m_history[(m_historyIndex + BIN_COUNT + i) % FFT_SIZE];
+            const auto level = std::clamp(sample * 0.5f + 0.5f, 0.f, 1.f);
+            writePixel(BIN_COUNT + i, static_cast<std::uint8_t>(level * 255.f));
+        }
+    }
+
+    void writePixel(std::size_t index, std::uint8_t value)
+    {
+        auto& output = m_frames.back();
+        output[index * 4 + 0] = value;
+        output[index * 4 + 1] = value;
+        output[index * 4 + 2] = value;
+        output[index * 4 + 3] = 255;
+    }
+
+    std::array<float, FFT_SIZE> m_window {};
+    std::array<std::size_t, FFT_SIZE> m_bitReverse {};
+    std::array<float, FFT_SIZE> m_twiddleRe {};
+    std::array<float, FFT_SIZE> m_twiddleIm {};
+    std::array<float, FFT_SIZE> m_history {};
+    std::array<float, FFT_SIZE> m_re {};
+    std::array<float, FFT_SIZE> m_im {};
+    std::array<float, BIN_COUNT> m_smoothed {};
+    std::size_t m_historyIndex { 0 };
+    TripleBuffer<Frame> m_frames;
+};
+
+// Loops an audio file, analysing each chunk as it's handed to the
+// device. That runs ahead of what's audible by the few chunks SFML
+// keeps queued, roughly 35ms at 44.1kHz.
+class AudioChannel::FileStream : public sf::SoundStream {
+public:
+    explicit FileStream(Analyser& analyser)
+        : m_analyser(analyser)
+    {
+    }
+
+    ~FileStream() override { stop(); }
+
+    [[nodiscard]] bool open(const std::string& path)
+    {
+        if (!m_file.openFromFile(path))
+            return false;
+
+        m_samples.resize(STREAM_CHUNK_FRAMES * m_file.getChannelCount());
+        initialize(m_file.getChannelCount(), m_file.getSampleRate());
+        setLoop(true);
+        return true;
+    }
+
+private:
+    bool onGetData(Chunk& data) override
+    {
+        const auto count = static_cast<std::size_t>(m_file.read(m_samples.data(), m_samples.size()));
+        m_analyser.process(m_samples.data(), count, m_file.getChannelCount());
+
+        data.samples = m_samples.data();
+        data.sampleCount = count;
+        return count == m_samples.size();
+    }
+
+    void onSeek(sf::Time timeOffset) override { m_file.seek(timeOffset); }
+
+    Analyser& m_analyser;
+    sf::InputSoundFile m_file;
+    std::vector<std::int16_t> m_samples;
+};
+
+class AudioChannel::Recorder : public sf::SoundRecorder {
+public:
+    explicit Recorder(Analyser& analyser)
+        : m_analyser(analyser)
+    {
+        // The default of 100ms between callbacks is far too laggy
+        setProcessingInterval(sf::milliseconds(10));
+    }
+
+    ~Recorder() override { stop(); }
+
+private:
+    bool onProcessSamples(const std::int16_t* samples, std::size_t sampleCount) override
+    {
+        m_analyser.process(samples, sampleCount, getChannelCount());
+        return true;
+    }
+
+    Analyser& m_analyser;
+};
+
+AudioChannel::AudioChannel()
+    : m_analyser(std::make_unique<Analyser>())
+{
+}
+
+AudioChannel::~AudioChannel() = default;
+
+bool AudioChannel::isAudioPath(std::string_view path)
+{
+    if (isCapturePath(path))
+        return true;
+
+    const auto extension = std::filesystem::path(path).extension().string();
+    return std::find(AUDIO_EXTENSIONS.begin(), AUDIO_EXTENSIONS.end(), extension) != AUDIO_EXTENSIONS.end();
+}
+
+std::optional<std::string> AudioChannel::open(std::string_view path)
+{
+    std::optional<std::string> result;
+    if (!m_texture.create({ static_cast<unsigned>(BIN_COUNT), 2 })) {
+        result.emplace("Unable to create audio texture");
+        return result;
+    }
+    m_texture.update(m_frame.data());
+
+    ErrorCapture errCapture;
+
+    if (isCapturePath(path)) {
+        const auto device = path.size() > MIC_PREFIX.size() ? path.substr(MIC_PREFIX.size() + 1) : std::string_view {};
+        m_recorder = std::make_unique<Recorder>(*m_analyser);
+        if (!sf::SoundRecorder::isAvailable()) {
+            result.emplace("Audio capture is not available");
+        } else if (!device.empty() && !m_recorder->setDevice(std::string(device))) {
+            result.emplace(fmt::format("Unable to use capture device {}\n{}", device, errCapture.str()));
+        } else if (!m_recorder->start(CAPTURE_SAMPLE_RATE)) {
+            result.emplace(fmt::format("Unable to start capturing\n{}", errCapture.str()));
+        }
+    } else {
+        m_stream = std::make_unique<FileStream>(*m_analyser);
+        if (!m_stream->open(std::string(path))) {
+            result.emplace(errCapture.str());
+        } else {
+            m_stream->play();
+        }
+    }
+
+    return result;
+}
+
+void AudioChannel::update()
+{
+    // Only ever hands back the newest analysis
+    if (m_analyser->pop(m_frame))
+        m_texture.update(m_frame.data());
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <SFML/Graphics/Texture.hpp>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Shadertoy style sound input: a 512x2 texture whose first row holds
+// the spectrum & second row the waveform of whatever is playing. The
+// source is either an audio file, played on loop, or "mic" / "mic:<device>"
+// to capture from an input device.
+class AudioChannel {
+public:
+    static constexpr std::size_t FFT_SIZE { 1024 };
+    static constexpr std::size_t BIN_COUNT { FFT_SIZE / 2 };
+
+    // RGBA pixels for both rows of the texture
+    using Frame = std::array<std::uint8_t, BIN_COUNT * 2 * 4>;
+
+    AudioChannel();
+    AudioChannel(const AudioChannel&) = delete;
+    AudioChannel& operator=(const AudioChannel&) = delete;
+    ~AudioChannel();
+
+    [[nodiscard]] static bool isAudioPath(std::string_view path);
+
+    [[nodiscard]] std::optional<std::string> open(std::string_view path);
+
+    // Upload the newest analysis from the audio thread, if any
+    void update();
+
+    [[nodiscard]] auto getTexture() -> sf::Texture& { return m_texture; }
+
+private:
+    class Analyser;
+    class FileStream;
+    class Recorder;
+
+    std::unique_ptr<Analyser> m_analyser;
+    std::unique_ptr<FileStream> m_stream;
+    std::unique_ptr<Recorder> m_recorder;
+    sf::Texture m_texture;
+    Frame m_frame {};
+};
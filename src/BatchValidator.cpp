@@ -0,0 +1,260 @@
+#include "BatchValidator.hpp"
+#include "ShaderManager.hpp"
+
+#include <SFML/Graphics/Shader.hpp>
+#include <SFML/Window/Context.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <future>
+#include <spdlog/fmt/fmt.h>
+#include <spdlog/spdlog.h>
+#include <sstream>
+#include <thread>
+
+namespace {
+std::string escapeJson(std::string_view str)
+{
+    std::string result;
+    result.reserve(str.size());
+    for (const auto c : str) {
+        switch (c) {
+        case '"':
+            result += "\\\"";
+            break;
+        case '\\':
+            result += "\\\\";
+            break;
+        case '\n':
+            result += "\\n";
+            break;
+        case '\r':
+            result += "\\r";
+            break;
+        case '\t':
+            result += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+                result += fmt::format("\\u{:04x}", static_cast<unsigned>(c));
+            else
+                result += c;
+        }
+    }
+    return result;
+}
+
+std::string makeResult(bool ok,
+                       const std::filesystem::path& path,
+                       std::string_view mode,
+                       double compileMs,
+                       std::string_view log)
+{
+    // "ok" stays the first key, the parent process only
+    // looks at that prefix rather than parsing each line
+    return fmt::format(R"({{"ok":{},"path":"{}","mode":"{}","compileMs":{:.3f},"log":"{}"}})",
+                       ok,
+                       escapeJson(path.generic_string()),
+                       mode,
+                       compileMs,
+                       escapeJson(log));
+}
+
+bool isPassingResult(std::string_view line) { return line.substr(0, 10) == R"({"ok":true)"; }
+
+std::string quote(const std::filesystem::path& path) { return "\"" + path.string() + "\""; }
+
+// Run worker processes over the shaders until every one has a result,
+// starting a fresh process after whichever shader took the last one down
+std::vector<std::string> runShard(const std::filesystem::path& executable,
+                                  const std::filesystem::path& workDirectory,
+                                  std::size_t shardIndex,
+                                  std::vector<std::filesystem::path> shaders)
+{
+    std::vector<std::string> results;
+    std::size_t attempt = 0;
+    while (!shaders.empty()) {
+        const auto listPath = workDirectory / fmt::format("shard{}-{}.txt", shardIndex, attempt);
+        const auto resultsPath = workDirectory / fmt::format("shard{}-{}.jsonl", shardIndex, attempt);
+        ++attempt;
+        {
+            std::ofstream list(listPath);
+            for (const auto& shader : shaders)
+                list << shader.string() << '\n';
+        }
+
+        auto command
+            = fmt::format("{} --validate-worker {} {}", quote(executable), quote(listPath), quote(resultsPath));
+#ifdef _WIN32
+        // cmd.exe strips the outer quotes when the command starts with one
+        command = "\"" + command + "\"";
+#endif
+        if (std::system(command.data()) != 0)
+            spdlog::debug("Worker for shard {} exited abnormally", shardIndex);
+
+        std::size_t completed = 0;
+        std::ifstream resultsFile(resultsPath);
+        std::string line;
+        while (completed < shaders.size() && std::getline(resultsFile, line)) {
+            results.push_back(line);
+            ++completed;
+        }
+
+        if (completed == shaders.size())
+            break;
+
+        results.push_back(
+            makeResult(false, shaders[completed], "unknown", 0.0, "Compiler process exited unexpectedly"));
+        shaders.erase(shaders.begin(), shaders.begin() + static_cast<std::ptrdiff_t>(completed + 1));
+    }
+
+    return results;
+}
+}
+
+BatchValidator::BatchValidator(Options options)
+    : m_options(std::move(options))
+{
+}
+
+std::vector<std::filesystem::path> BatchValidator::findShaders() const
+{
+    std::vector<std::filesystem::path> shaders;
+    std::error_code ec;
+    for (auto it = std::filesystem::recursive_directory_iterator(m_options.directory, ec);
+         !ec && it != std::filesystem::recursive_directory_iterator();
+         it.increment(ec)) {
+        if (it->is_regular_file(ec) && ShaderManager::isShaderFile(it->path()))
+            shaders.push_back(std::filesystem::absolute(it->path()));
+    }
+
+    std::sort(shaders.begin(), shaders.end());
+    return shaders;
+}
+
+int BatchValidator::run()
+{
+    if (!std::filesystem::is_directory(m_options.directory)) {
+        spdlog::error("{} is not a directory", m_options.directory.string());
+        return 1;
+    }
+
+    const auto shaders = findShaders();
+    if (shaders.empty()) {
+        spdlog::warn("No shaders found in {}", m_options.directory.string());
+        return 0;
+    }
+
+    // Mesa picks this up in the children, giving results that don't
+    // depend on whatever GPU the machine running the check has
+    if (m_options.softwareDriver) {
+#ifdef _WIN32
+        _putenv_s("LIBGL_ALWAYS_SOFTWARE", "1");
+#else
+        setenv("LIBGL_ALWAYS_SOFTWARE", "1", 1);
+#endif
+    }
+
+    const auto hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    const auto jobs = std::min<std::size_t>(m_options.jobs ? m_options.jobs : hardwareThreads, shaders.size());
+
+    const auto workDirectory = std::filesystem::temp_directory_path()
+        / fmt::format("shader-playground-{}", std::chrono::steady_clock::now().time_since_epoch().count());
+    std::filesystem::create_directories(workDirectory);
+
+    spdlog::info("Validating {} shaders with {} worker(s)", shaders.size(), jobs);
+    const auto start = std::chrono::steady_clock::now();
+
+    // Contiguous shards keep the report in sorted path order
+    std::vector<std::future<std::vector<std::string>>> shards;
+    const auto shardSize = (shaders.size() + jobs - 1) / jobs;
+    for (std::size_t i = 0; i < jobs; ++i) {
+        const auto firstIndex = std::min(i * shardSize, shaders.size());
+        const auto lastIndex = std::min((i + 1) * shardSize, shaders.size());
+        const auto first = shaders.begin() + static_cast<std::ptrdiff_t>(firstIndex);
+        const auto last = shaders.begin() + static_cast<std::ptrdiff_t>(lastIndex);
+        shards.push_back(std::async(std::launch::async,
+                                    runShard,
+                                    m_options.executable,
+                                    workDirectory,
+                                    i,
+                                    std::vector<std::filesystem::path>(first, last)));
+    }
+
+    std::vector<std::string> results;
+    for (auto& shard : shards) {
+        auto shardResults = shard.get();
+        results.insert(results.end(), shardResults.begin(), shardResults.end());
+    }
+
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const auto passed = static_cast<std::size_t>(std::count_if(results.begin(), results.end(), isPassingResult));
+    std::error_code ec;
+    std::filesystem::remove_all(workDirectory, ec);
+
+    std::ofstream report(m_options.reportPath);
+    if (!report) {
+        spdlog::error("Unable to write report to {}", m_options.reportPath.string());
+        return 1;
+    }
+
+    report << fmt::format(R"({{"directory":"{}","total":{},"passed":{},"failed":{},"seconds":{:.3f},"results":[)",
+                          escapeJson(std::filesystem::absolute(m_options.directory).generic_string()),
+                          results.size(),
+                          passed,
+                          results.size() - passed,
+                          elapsed)
+           << '\n';
+    for (std::size_t i = 0; i < results.size(); ++i)
+        report << results[i] << (i + 1 < results.size() ? ",\n" : "\n");
+    report << "]}\n";
+
+    spdlog::info("{}/{} shaders compiled in {:.2f}s, report written to {}",
+                 passed,
+                 results.size(),
+                 elapsed,
+                 m_options.reportPath.string());
+    return passed == results.size() ? 0 : 1;
+}
+
+int BatchValidator::runWorker(const std::filesystem::path& listPath, const std::filesystem::path& resultsPath)
+{
+    std::ifstream list(listPath);
+    std::ofstream results(resultsPath);
+    if (!list || !results)
+        return 1;
+
+    sf::Context context;
+    const bool shadersAvailable = sf::Shader::isAvailable();
+
+    std::string line;
+    while (std::getline(list, line)) {
+        const std::filesystem::path path = line;
+        std::ifstream file(path);
+        std::stringstream source;
+        source << file.rdbuf();
+        const auto sourceStr = source.str();
+        const bool useShadertoy = ShaderManager::isShadertoySource(sourceStr);
+        const auto mode = useShadertoy ? "shadertoy" : "default";
+
+        if (!file || sourceStr.empty()) {
+            results << makeResult(false, path, mode, 0.0, "Unable to read shader, or it is empty") << '\n';
+        } else if (!shadersAvailable) {
+            results << makeResult(false, path, mode, 0.0, "Shaders are not available") << '\n';
+        } else {
+            ShaderManager shaderMgr;
+            const auto start = std::chrono::steady_clock::now();
+            const auto error = shaderMgr.loadAndCompile(sourceStr, useShadertoy);
+            const auto compileMs
+                = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            results << makeResult(!error, path, mode, compileMs, error.value_or("")) << '\n';
+        }
+
+        // Flushing each line means a crash part way through
+        // still leaves the results for everything before it
+        results.flush();
+    }
+
+    return 0;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// Command line mode that compiles every shader in a directory with the
+// same preamble the editor would use & writes a JSON report of the
+// results. The work is split across child processes of this executable,
+// so a driver crash only loses the shader that caused it.
+class BatchValidator {
+public:
+    struct Options {
+        std::filesystem::path directory;
+        std::filesystem::path reportPath { "validation-report.json" };
+        std::filesystem::path executable;
+        unsigned jobs { 0 };
+        bool softwareDriver { true };
+    };
+
+    explicit BatchValidator(Options options);
+
+    // Returns the process exit code, non zero if anything failed
+    [[nodiscard]] int run();
+
+    // Entry point for the child processes, compiles every shader listed
+    // in listPath & writes one JSON object per line to resultsPath
+    [[nodiscard]] static int runWorker(const std::filesystem::path& listPath,
+                                       const std::filesystem::path& resultsPath);
+
+private:
+    [[nodiscard]] std::vector<std::filesystem::path> findShaders() const;
+
+    Options m_options;
+};
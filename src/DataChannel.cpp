@@ -0,0 +1,325 @@
+#include "DataChannel.hpp"
+#include "Tracer.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <spdlog/fmt/fmt.h>
+#include <sstream>
+
+namespace {
+constexpr std::size_t PAGE_SIZE { 4096 };
+
+std::string trim(const std::string& str)
+{
+    const auto first = str.find_first_not_of(" \t\r");
+    if (first == std::string::npos)
+        return {};
+
+    const auto last = str.find_last_not_of(" \t\r");
+    return str.substr(first, last - first + 1);
+}
+
+std::filesystem::path getHeaderPath(const std::filesystem::path& path)
+{
+    if (path.extension() == ".meta")
+        return path;
+
+    auto headerPath = path;
+    headerPath += ".meta";
+    return headerPath;
+}
+
+std::filesystem::path getRawPath(const std::filesystem::path& path)
+{
+    if (path.extension() == ".meta")
+        return path.parent_path() / path.stem();
+
+    return path;
+}
+}
+
+DataChannel::~DataChannel()
+{
+    {
+        std::lock_guard lock(m_prefetchMutex);
+        m_stopPrefetch = true;
+    }
+    m_prefetchCondition.notify_one();
+    if (m_prefetchThread.joinable())
+        m_prefetchThread.join();
+
+    destroyUploadBuffers();
+}
+
+bool DataChannel::isDataPath(const std::filesystem::path& path)
+{
+    std::error_code ec;
+    return path.extension() == ".raw" || path.extension() == ".meta"
+        || std::filesystem::exists(getHeaderPath(path), ec);
+}
+
+std::optional<std::string> DataChannel::open(const std::filesystem::path& path)
+{
+    // Channels get a fresh DataChannel each time the path changes,
+    // so there's never a previous file to tear down here
+    std::optional<std::string> result = parseHeader(getHeaderPath(path));
+    if (result)
+        return result;
+
+    result = m_file.open(getRawPath(path));
+    if (result)
+        return result;
+
+    const auto sliceBytes = getSliceBytes();
+    const auto available = m_file.size() > m_header.offset ? m_file.size() - m_header.offset : 0;
+    if (m_header.sliceCount == 0)
+        m_header.sliceCount = available / sliceBytes;
+
+    if (m_header.sliceCount == 0 || m_header.sliceCount > available / sliceBytes) {
+        result.emplace(fmt::format("{} is too small for {} slice(s) of {}x{}",
+                                   path.string(),
+                                   std::max(m_header.sliceCount, std::size_t { 1 }),
+                                   m_header.size.x,
+                                   m_header.size.y));
+        return result;
+    }
+
+    if (!m_texture.create(m_header.size)) {
+        result.emplace(fmt::format("Unable to create a {}x{} texture", m_header.size.x, m_header.size.y));
+        return result;
+    }
+
+    // sf::Texture only deals in RGBA8, so respecify the storage
+    // as a single channel the raw samples can be copied into.
+    // Anything already flagged isn't ours, so clear it out first
+    for (int i = 0; i < 8 && glGetError() != GL_NO_ERROR; ++i) { }
+
+    const bool isFloat = m_header.format == Format::Float32;
+    sf::Texture::bind(&m_texture);
+    glTexImage2D(GL_TEXTURE_2D,
+                 0,
+                 static_cast<GLint>(isFloat ? glext::R32F : glext::R16),
+                 static_cast<GLsizei>(m_header.size.x),
+                 static_cast<GLsizei>(m_header.size.y),
+                 0,
+                 GL_RED,
+                 isFloat ? GL_FLOAT : GL_UNSIGNED_SHORT,
+                 nullptr);
+    const auto error = glGetError();
+    sf::Texture::bind(nullptr);
+
+    // R32F & R16 need OpenGL 3.0 or ARB_texture_rg, legacy
+    // contexts reject them & leave the texture incomplete
+    if (error != GL_NO_ERROR) {
+        result.emplace(fmt::format("This OpenGL context can't store {} single channel textures (GL error {:#x})",
+                                   isFloat ? "float32" : "uint16",
+                                   error));
+        return result;
+    }
+
+    createUploadBuffers();
+    m_prefetchThread = std::thread(&DataChannel::prefetchWorker, this);
+    return result;
+}
+
+std::optional<std::string> DataChannel::parseHeader(const std::filesystem::path& headerPath)
+{
+    std::optional<std::string> result;
+    std::ifstream file(headerPath);
+    if (!file) {
+        result.emplace(fmt::format("Data header {} not found", headerPath.string()));
+        return result;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        const auto comment = line.find('#');
+        if (comment != std::string::npos)
+            line.resize(comment);
+
+        const auto separator = line.find('=');
+        if (separator == std::string::npos)
+            continue;
+
+        const auto key = trim(line.substr(0, separator));
+        const auto value = trim(line.substr(separator + 1));
+        try {
+            if (key == "width") {
+                m_header.size.x = static_cast<unsigned>(std::stoul(value));
+            } else if (key == "height") {
+                m_header.size.y = static_cast<unsigned>(std::stoul(value));
+            } else if (key == "slices") {
+                m_header.sliceCount = std::stoull(value);
+            } else if (key == "offset") {
+                m_header.offset = std::stoull(value);
+            } else if (key == "format") {
+                if (value == "float32") {
+                    m_header.format = Format::Float32;
+                } else if (value == "uint16") {
+                    m_header.format = Format::UInt16;
+                } else {
+                    result.emplace(fmt::format("Unknown data format '{}', expected float32 or uint16", value));
+                    return result;
+                }
+            }
+        } catch (const std::exception&) {
+            result.emplace(fmt::format("Invalid value '{}' for '{}' in {}", value, key, headerPath.string()));
+            return result;
+        }
+    }
+
+    // Bounding the size by what a texture can hold also keeps
+    // the slice size well clear of overflowing
+    const auto maximumSize = sf::Texture::getMaximumSize();
+    if (m_header.size.x == 0 || m_header.size.y == 0)
+        result.emplace(fmt::format("{} needs a non zero width & height", headerPath.string()));
+    else if (m_header.size.x > maximumSize || m_header.size.y > maximumSize)
+        result.emplace(
+            fmt::format("{} is larger than the maximum texture size of {}", headerPath.string(), maximumSize));
+
+    return result;
+}
+
+std::size_t DataChannel::getSliceBytes() const
+{
+    const std::size_t sampleBytes = m_header.format == Format::Float32 ? sizeof(float) : sizeof(std::uint16_t);
+    return std::size_t { m_header.size.x } * m_header.size.y * sampleBytes;
+}
+
+const std::uint8_t* DataChannel::getSliceData(std::size_t slice) const
+{
+    return m_file.data() + m_header.offset + slice * getSliceBytes();
+}
+
+void DataChannel::update(std::int32_t frame)
+{
+    if (m_header.sliceCount == 0)
+        return;
+
+    const auto slice = static_cast<std::size_t>(std::max(frame, 0)) % m_header.sliceCount;
+    if (m_currentSlice == slice)
+        return;
+
+    upload(slice);
+    {
+        std::lock_guard lock(m_prefetchMutex);
+        m_prefetchFrom = slice + 1;
+    }
+    m_prefetchCondition.notify_one();
+}
+
+void DataChannel::createUploadBuffers()
+{
+    glext::load();
+    if (!glext::hasPersistentBuffers())
+        return;
+
+    const auto& gl = glext::functions();
+    const auto totalBytes = static_cast<std::ptrdiff_t>(getSliceBytes() * UPLOAD_BUFFER_COUNT);
+    const auto flags = glext::MAP_WRITE_BIT | glext::MAP_PERSISTENT_BIT | glext::MAP_COHERENT_BIT;
+    gl.genBuffers(1, &m_uploadBuffer);
+    gl.bindBuffer(glext::PIXEL_UNPACK_BUFFER, m_uploadBuffer);
+    gl.bufferStorage(glext::PIXEL_UNPACK_BUFFER, totalBytes, nullptr, flags);
+    m_uploadMemory = static_cast<std::uint8_t*>(gl.mapBufferRange(glext::PIXEL_UNPACK_BUFFER, 0, totalBytes, flags));
+    gl.bindBuffer(glext::PIXEL_UNPACK_BUFFER, 0);
+
+    if (!m_uploadMemory)
+        destroyUploadBuffers();
+}
+
+void DataChannel::destroyUploadBuffers()
+{
+    if (!m_uploadBuffer)
+        return;
+
+    const auto& gl = glext::functions();
+    for (auto& fence : m_uploadFences) {
+        if (fence)
+            gl.deleteSync(fence);
+        fence = nullptr;
+    }
+
+    if (m_uploadMemory) {
+        gl.bindBuffer(glext::PIXEL_UNPACK_BUFFER, m_uploadBuffer);
+        gl.unmapBuffer(glext::PIXEL_UNPACK_BUFFER);
+        gl.bindBuffer(glext::PIXEL_UNPACK_BUFFER, 0);
+    }
+    gl.deleteBuffers(1, &m_uploadBuffer);
+    m_uploadBuffer = 0;
+    m_uploadMemory = nullptr;
+}
+
+void DataChannel::upload(std::size_t slice)
+{
+    TRACE_SCOPE("DataChannel::upload");
+    const auto sliceBytes = getSliceBytes();
+    const GLenum type = m_header.format == Format::Float32 ? GL_FLOAT : GL_UNSIGNED_SHORT;
+    const auto width = static_cast<GLsizei>(m_header.size.x);
+    const auto height = static_cast<GLsizei>(m_header.size.y);
+    const void* pixels = getSliceData(slice);
+
+    if (m_uploadMemory) {
+        // The region was last used UPLOAD_BUFFER_COUNT uploads ago, so the
+        // fence has nearly always passed. If not, keep showing the old
+        // slice this frame rather than stall the render thread
+        const auto& gl = glext::functions();
+        auto& fence = m_uploadFences[m_uploadIndex];
+        if (fence) {
+            const auto status = gl.clientWaitSync(fence, glext::SYNC_FLUSH_COMMANDS_BIT, 0);
+            if (status != glext::ALREADY_SIGNALED && status != glext::CONDITION_SATISFIED)
+                return;
+
+            gl.deleteSync(fence);
+            fence = nullptr;
+        }
+
+        // The only CPU copy, straight from the mapped file pages
+        // into memory the driver reads from
+        const auto regionOffset = m_uploadIndex * sliceBytes;
+        std::memcpy(m_uploadMemory + regionOffset, pixels, sliceBytes);
+        gl.bindBuffer(glext::PIXEL_UNPACK_BUFFER, m_uploadBuffer);
+        pixels = reinterpret_cast<const void*>(regionOffset);
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    sf::Texture::bind(&m_texture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RED, type, pixels);
+    sf::Texture::bind(nullptr);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    if (m_uploadMemory) {
+        const auto& gl = glext::functions();
+        gl.bindBuffer(glext::PIXEL_UNPACK_BUFFER, 0);
+        m_uploadFences[m_uploadIndex] = gl.fenceSync(glext::SYNC_GPU_COMMANDS_COMPLETE, 0);
+        m_uploadIndex = (m_uploadIndex + 1) % UPLOAD_BUFFER_COUNT;
+    }
+
+    m_currentSlice = slice;
+}
+
+void DataChannel::prefetchWorker()
+{
+    // Touch a byte on every page of the next few slices so they're
+    // resident by the time the render thread copies them out
+    volatile std::uint8_t sink = 0;
+    std::unique_lock lock(m_prefetchMutex);
+    while (true) {
+        m_prefetchCondition.wait(lock, [this] { return m_stopPrefetch || m_prefetchFrom.has_value(); });
+        if (m_stopPrefetch)
+            return;
+
+        const auto from = m_prefetchFrom.value();
+        m_prefetchFrom.reset();
+        lock.unlock();
+
+        const auto sliceBytes = getSliceBytes();
+        for (std::size_t i = 0; i < PREFETCH_SLICES && i < m_header.sliceCount; ++i) {
+            const auto* data = getSliceData((from + i) % m_header.sliceCount);
+            for (std::size_t offset = 0; offset < sliceBytes; offset += PAGE_SIZE)
+                sink = static_cast<std::uint8_t>(sink ^ data[offset]);
+        }
+
+        lock.lock();
+    }
+}
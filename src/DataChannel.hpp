@@ -0,0 +1,83 @@
+#pragma once
+
+#include "GlExtensions.hpp"
+#include "MappedFile.hpp"
+
+#include <SFML/Graphics/Texture.hpp>
+#include <array>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+// Texture channel backed by a memory mapped raw array of 2D slices,
+// described by a sidecar "<file>.meta" made of key = value lines:
+//
+//     width = 512
+//     height = 256
+//     format = float32    (or uint16)
+//     slices = 100        (optional, defaults to whatever fits)
+//     offset = 0          (optional, bytes to skip at the start)
+//
+// The slice for the current frame is streamed into a single channel
+// float texture, so shaders read the value from the red component.
+class DataChannel {
+public:
+    enum class Format { Float32, UInt16 };
+
+    struct Header {
+        sf::Vector2u size;
+        Format format { Format::Float32 };
+        std::size_t sliceCount { 0 };
+        std::size_t offset { 0 };
+    };
+
+    DataChannel() = default;
+    DataChannel(const DataChannel&) = delete;
+    DataChannel& operator=(const DataChannel&) = delete;
+    ~DataChannel();
+
+    // Whether the path names a raw file or its header
+    [[nodiscard]] static bool isDataPath(const std::filesystem::path& path);
+
+    [[nodiscard]] std::optional<std::string> open(const std::filesystem::path& path);
+
+    // Upload the slice for this frame, playback loops once the
+    // last slice has been shown
+    void update(std::int32_t frame);
+
+    [[nodiscard]] auto getTexture() -> sf::Texture& { return m_texture; }
+    [[nodiscard]] auto getHeader() const -> const Header& { return m_header; }
+
+private:
+    static constexpr std::size_t UPLOAD_BUFFER_COUNT { 3 };
+    static constexpr std::size_t PREFETCH_SLICES { 4 };
+
+    [[nodiscard]] std::optional<std::string> parseHeader(const std::filesystem::path& headerPath);
+    [[nodiscard]] auto getSliceBytes() const -> std::size_t;
+    [[nodiscard]] auto getSliceData(std::size_t slice) const -> const std::uint8_t*;
+    void createUploadBuffers();
+    void destroyUploadBuffers();
+    void upload(std::size_t slice);
+    void prefetchWorker();
+
+    Header m_header;
+    MappedFile m_file;
+    sf::Texture m_texture;
+    std::optional<std::size_t> m_currentSlice;
+
+    // Persistently mapped pixel unpack buffer split in regions
+    // the GPU reads from round robin, each guarded by a fence
+    GLuint m_uploadBuffer { 0 };
+    std::uint8_t* m_uploadMemory { nullptr };
+    std::array<glext::Sync, UPLOAD_BUFFER_COUNT> m_uploadFences {};
+    std::size_t m_uploadIndex { 0 };
+
+    std::thread m_prefetchThread;
+    std::mutex m_prefetchMutex;
+    std::condition_variable m_prefetchCondition;
+    std::optional<std::size_t> m_prefetchFrom;
+    bool m_stopPrefetch { false };
+};
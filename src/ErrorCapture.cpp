@@ -0,0 +1,72 @@
+#include "ErrorCapture.hpp"
+
+#include <SFML/System/Err.hpp>
+#include <mutex>
+#include <streambuf>
+
+namespace {
+thread_local std::string* t_capture { nullptr };
+
+// Unbuffered, so every write is routed by the thread making it
+class RoutingStreamBuf : public std::streambuf {
+public:
+    explicit RoutingStreamBuf(std::streambuf* fallback)
+        : m_fallback(fallback)
+    {
+    }
+
+protected:
+    int_type overflow(int_type ch) override
+    {
+        if (traits_type::eq_int_type(ch, traits_type::eof()))
+            return traits_type::not_eof(ch);
+
+        const auto c = traits_type::to_char_type(ch);
+        return xsputn(&c, 1) == 1 ? ch : traits_type::eof();
+    }
+
+    std::streamsize xsputn(const char* str, std::streamsize count) override
+    {
+        if (t_capture) {
+            t_capture->append(str, static_cast<std::size_t>(count));
+            return count;
+        }
+
+        std::lock_guard lock(m_mutex);
+        return m_fallback->sputn(str, count);
+    }
+
+    int sync() override
+    {
+        if (t_capture)
+            return 0;
+
+        std::lock_guard lock(m_mutex);
+        return m_fallback->pubsync();
+    }
+
+private:
+    std::streambuf* m_fallback;
+    std::mutex m_mutex;
+};
+}
+
+void ErrorCapture::install()
+{
+    // Deliberately leaked, SFML may still write to sf::err
+    // while statics are being torn down at exit
+    [[maybe_unused]] static const auto* streamBuf = [] {
+        auto* routing = new RoutingStreamBuf(sf::err().rdbuf());
+        sf::err().rdbuf(routing);
+        return routing;
+    }();
+}
+
+ErrorCapture::ErrorCapture()
+    : m_previous(t_capture)
+{
+    install();
+    t_capture = &m_buffer;
+}
+
+ErrorCapture::~ErrorCapture() { t_capture = m_previous; }
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+
+// Collects whatever SFML writes to sf::err on the calling thread while
+// it's alive. sf::err is global, so rather than swapping its streambuf
+// at runtime a single routing streambuf is installed up front: output
+// goes to the innermost capture on the writing thread, or on to the
+// original stream if that thread isn't capturing.
+class ErrorCapture {
+public:
+    // Install the routing streambuf, must run before any
+    // thread other than the main one touches SFML
+    static void install();
+
+    ErrorCapture();
+    ErrorCapture(const ErrorCapture&) = delete;
+    ErrorCapture& operator=(const ErrorCapture&) = delete;
+    ~ErrorCapture();
+
+    [[nodiscard]] auto str() const -> const std::string& { return m_buffer; }
+
+private:
+    std::string m_buffer;
+    std::string* m_previous { nullptr };
+};
@@ -0,0 +1,74 @@
+#include "GlExtensions.hpp"
+
+#include <SFML/Window/Context.hpp>
+#include <cstdio>
+
+namespace {
+glext::Functions s_functions;
+bool s_loaded { false };
+
+// Some platforms hand back a pointer for any name at all, so the
+// context version decides what we actually trust
+bool hasVersion(int major, int minor)
+{
+    const auto* version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+    int contextMajor = 0;
+    int contextMinor = 0;
+    if (!version || std::sscanf(version, "%d.%d", &contextMajor, &contextMinor) != 2)
+        return false;
+
+    return contextMajor > major || (contextMajor == major && contextMinor >= minor);
+}
+
+template <typename T>
+void resolve(T& function, const char* name)
+{
+    function = reinterpret_cast<T>(sf::Context::getFunction(name));
+}
+}
+
+namespace glext {
+void load()
+{
+    if (s_loaded)
+        return;
+
+    s_loaded = true;
+    if (hasVersion(3, 3)) {
+        resolve(s_functions.genQueries, "glGenQueries");
+        resolve(s_functions.deleteQueries, "glDeleteQueries");
+        resolve(s_functions.beginQuery, "glBeginQuery");
+        resolve(s_functions.endQuery, "glEndQuery");
+        resolve(s_functions.getQueryObjectiv, "glGetQueryObjectiv");
+        resolve(s_functions.getQueryObjectui64v, "glGetQueryObjectui64v");
+    }
+
+    if (hasVersion(4, 4)) {
+        resolve(s_functions.genBuffers, "glGenBuffers");
+        resolve(s_functions.deleteBuffers, "glDeleteBuffers");
+        resolve(s_functions.bindBuffer, "glBindBuffer");
+        resolve(s_functions.bufferStorage, "glBufferStorage");
+        resolve(s_functions.mapBufferRange, "glMapBufferRange");
+        resolve(s_functions.unmapBuffer, "glUnmapBuffer");
+
+        resolve(s_functions.fenceSync, "glFenceSync");
+        resolve(s_functions.clientWaitSync, "glClientWaitSync");
+        resolve(s_functions.deleteSync, "glDeleteSync");
+    }
+}
+
+const Functions& functions() { return s_functions; }
+
+bool hasTimerQuery()
+{
+    return s_functions.genQueries && s_functions.deleteQueries && s_functions.beginQuery && s_functions.endQuery
+        && s_functions.getQueryObjectiv && s_functions.getQueryObjectui64v;
+}
+
+bool hasPersistentBuffers()
+{
+    return s_functions.genBuffers && s_functions.deleteBuffers && s_functions.bindBuffer && s_functions.bufferStorage
+        && s_functions.mapBufferRange && s_functions.unmapBuffer && s_functions.fenceSync
+        && s_functions.clientWaitSync && s_functions.deleteSync;
+}
+}
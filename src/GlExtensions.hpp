@@ -0,0 +1,61 @@
+#pragma once
+
+#include <SFML/OpenGL.hpp>
+#include <cstddef>
+#include <cstdint>
+
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+// SFML only exposes the OpenGL 1.1 headers, so the few newer
+// entry points we need are resolved at runtime through
+// sf::Context::getFunction. load() needs an active context.
+namespace glext {
+constexpr GLenum TIME_ELAPSED { 0x88BF };
+constexpr GLenum QUERY_RESULT { 0x8866 };
+constexpr GLenum QUERY_RESULT_AVAILABLE { 0x8867 };
+constexpr GLenum PIXEL_UNPACK_BUFFER { 0x88EC };
+constexpr GLenum R16 { 0x822A };
+constexpr GLenum R32F { 0x822E };
+constexpr GLbitfield MAP_WRITE_BIT { 0x0002 };
+constexpr GLbitfield MAP_PERSISTENT_BIT { 0x0040 };
+constexpr GLbitfield MAP_COHERENT_BIT { 0x0080 };
+constexpr GLenum SYNC_GPU_COMMANDS_COMPLETE { 0x9117 };
+constexpr GLbitfield SYNC_FLUSH_COMMANDS_BIT { 0x0001 };
+constexpr GLenum ALREADY_SIGNALED { 0x911A };
+constexpr GLenum CONDITION_SATISFIED { 0x911C };
+
+using Sync = void*;
+
+struct Functions {
+    void(APIENTRY* genQueries)(GLsizei, GLuint*) { nullptr };
+    void(APIENTRY* deleteQueries)(GLsizei, const GLuint*) { nullptr };
+    void(APIENTRY* beginQuery)(GLenum, GLuint) { nullptr };
+    void(APIENTRY* endQuery)(GLenum) { nullptr };
+    void(APIENTRY* getQueryObjectiv)(GLuint, GLenum, GLint*) { nullptr };
+    void(APIENTRY* getQueryObjectui64v)(GLuint, GLenum, std::uint64_t*) { nullptr };
+
+    void(APIENTRY* genBuffers)(GLsizei, GLuint*) { nullptr };
+    void(APIENTRY* deleteBuffers)(GLsizei, const GLuint*) { nullptr };
+    void(APIENTRY* bindBuffer)(GLenum, GLuint) { nullptr };
+    void(APIENTRY* bufferStorage)(GLenum, std::ptrdiff_t, const void*, GLbitfield) { nullptr };
+    void*(APIENTRY* mapBufferRange)(GLenum, std::intptr_t, std::ptrdiff_t, GLbitfield) { nullptr };
+    GLboolean(APIENTRY* unmapBuffer)(GLenum) { nullptr };
+
+    Sync(APIENTRY* fenceSync)(GLenum, GLbitfield) { nullptr };
+    GLenum(APIENTRY* clientWaitSync)(Sync, GLbitfield, std::uint64_t) { nullptr };
+    void(APIENTRY* deleteSync)(Sync) { nullptr };
+};
+
+// Resolve the entry points, safe to call repeatedly
+void load();
+
+[[nodiscard]] const Functions& functions();
+
+// GL_ARB_timer_query / OpenGL 3.3
+[[nodiscard]] bool hasTimerQuery();
+
+// GL_ARB_buffer_storage & GL_ARB_sync / OpenGL 4.4
+[[nodiscard]] bool hasPersistentBuffers();
+}
@@ -0,0 +1,71 @@
+#include "GpuTimer.hpp"
+#include "GlExtensions.hpp"
+
+GpuTimer::~GpuTimer()
+{
+    if (m_supported)
+        glext::functions().deleteQueries(static_cast<GLsizei>(m_queries.size()), m_queries.data());
+}
+
+bool GpuTimer::init()
+{
+    if (m_initialised)
+        return m_supported;
+
+    m_initialised = true;
+    glext::load();
+    m_supported = glext::hasTimerQuery();
+    if (m_supported)
+        glext::functions().genQueries(static_cast<GLsizei>(m_queries.size()), m_queries.data());
+
+    return m_supported;
+}
+
+bool GpuTimer::canBegin()
+{
+    // If every query is still in flight we skip this
+    // measurement rather than block on the oldest one
+    return init() && !m_running && m_pending < m_queries.size();
+}
+
+bool GpuTimer::begin()
+{
+    if (!canBegin())
+        return false;
+
+    glext::functions().beginQuery(glext::TIME_ELAPSED, m_queries[m_writeIndex]);
+    m_running = true;
+    return true;
+}
+
+void GpuTimer::end()
+{
+    if (!m_running)
+        return;
+
+    glext::functions().endQuery(glext::TIME_ELAPSED);
+    m_writeIndex = (m_writeIndex + 1) % m_queries.size();
+    ++m_pending;
+    m_running = false;
+}
+
+std::optional<sf::Time> GpuTimer::poll()
+{
+    std::optional<sf::Time> result;
+    if (m_pending == 0)
+        return result;
+
+    const auto& gl = glext::functions();
+    GLint available = 0;
+    gl.getQueryObjectiv(m_queries[m_readIndex], glext::QUERY_RESULT_AVAILABLE, &available);
+    if (!available)
+        return result;
+
+    std::uint64_t nanoseconds = 0;
+    gl.getQueryObjectui64v(m_queries[m_readIndex], glext::QUERY_RESULT, &nanoseconds);
+    m_readIndex = (m_readIndex + 1) % m_queries.size();
+    --m_pending;
+
+    result.emplace(sf::microseconds(static_cast<std::int64_t>(nanoseconds / 1000)));
+    return result;
+}
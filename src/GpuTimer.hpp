@@ -0,0 +1,44 @@
+#pragma once
+
+#include <SFML/OpenGL.hpp>
+#include <SFML/System/Time.hpp>
+#include <array>
+#include <cstddef>
+#include <optional>
+
+// Measures GPU time of the commands issued between begin() & end()
+// with GL_TIME_ELAPSED queries. Results are read back a few frames
+// later so we never stall waiting on the GPU. Only one timer may be
+// running at a time, and it must stay on the context that created it.
+class GpuTimer {
+public:
+    GpuTimer() = default;
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+    ~GpuTimer();
+
+    // Whether begin() would start a measurement right now
+    [[nodiscard]] bool canBegin();
+
+    // Returns false if this measurement was skipped
+    bool begin();
+    void end();
+
+    // Returns the oldest finished measurement, if one is ready
+    [[nodiscard]] std::optional<sf::Time> poll();
+
+    [[nodiscard]] auto isSupported() const -> bool { return m_supported; }
+
+private:
+    static constexpr std::size_t QUERY_COUNT { 4 };
+
+    bool init();
+
+    std::array<GLuint, QUERY_COUNT> m_queries {};
+    std::size_t m_readIndex { 0 };
+    std::size_t m_writeIndex { 0 };
+    std::size_t m_pending { 0 };
+    bool m_initialised { false };
+    bool m_supported { false };
+    bool m_running { false };
+};
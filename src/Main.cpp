@@ -1,16 +1,68 @@
 #include "App.hpp"
+#include "BatchValidator.hpp"
+#include "ErrorCapture.hpp"
 
 #include <SFML/GpuPreference.hpp>
+#include <cstdlib>
+#include <spdlog/spdlog.h>
+#include <string_view>
+#include <vector>
 
 SFML_DEFINE_DISCRETE_GPU_PREFERENCE
 
+namespace {
+constexpr auto USAGE { "Usage: shader-playground [--validate <directory> [--report <file>] [--jobs <count>] "
+                       "[--hardware]]" };
+
+int runValidator(const std::vector<std::string_view>& args, const char* executable)
+{
+    BatchValidator::Options options;
+    options.directory = args[2];
+
+    // Workers are started through the shell, so only a path that
+    // names a location needs anchoring to the current directory
+    options.executable = executable;
+    if (options.executable.has_parent_path())
+        options.executable = std::filesystem::absolute(options.executable);
+
+    for (std::size_t i = 3; i < args.size(); ++i) {
+        if (args[i] == "--report" && i + 1 < args.size()) {
+            options.reportPath = args[++i];
+        } else if (args[i] == "--jobs" && i + 1 < args.size()) {
+            options.jobs = static_cast<unsigned>(std::strtoul(args[++i].data(), nullptr, 10));
+        } else if (args[i] == "--hardware") {
+            options.softwareDriver = false;
+        } else {
+            spdlog::error("{}", USAGE);
+            return 1;
+        }
+    }
+
+    BatchValidator validator(options);
+    return validator.run();
+}
+}
+
 int main(int argc, char* argv[])
 {
-    (void)(argc);
-    (void)(argv);
+    // Before anything can start a thread that talks to SFML
+    ErrorCapture::install();
+
+    const std::vector<std::string_view> args(argv, argv + argc);
+
+    if (args.size() == 4 && args[1] == "--validate-worker")
+        return BatchValidator::runWorker(args[2], args[3]);
+
+    if (args.size() >= 3 && args[1] == "--validate")
+        return runValidator(args, argv[0]);
+
+    if (args.size() > 1) {
+        spdlog::error("{}", USAGE);
+        return 1;
+    }
 
     App app;
     app.run();
 
     return 0;
-}
\ No newline at end of file
+}
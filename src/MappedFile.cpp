@@ -0,0 +1,113 @@
+#include "MappedFile.hpp"
+
+#include <spdlog/fmt/fmt.h>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() { close(); }
+
+#ifdef _WIN32
+std::optional<std::string> MappedFile::open(const std::filesystem::path& path)
+{
+    std::optional<std::string> result;
+    close();
+
+    m_file = CreateFileW(path.c_str(),
+                         GENERIC_READ,
+                         FILE_SHARE_READ,
+                         nullptr,
+                         OPEN_EXISTING,
+                         FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                         nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        m_file = nullptr;
+        result.emplace(fmt::format("Unable to open {}", path.string()));
+        return result;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(m_file, &fileSize) || fileSize.QuadPart == 0) {
+        close();
+        result.emplace(fmt::format("{} is empty", path.string()));
+        return result;
+    }
+
+    m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const auto* view = m_mapping ? MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        close();
+        result.emplace(fmt::format("Unable to map {}", path.string()));
+        return result;
+    }
+
+    m_data = static_cast<const std::uint8_t*>(view);
+    m_size = static_cast<std::size_t>(fileSize.QuadPart);
+    return result;
+}
+
+void MappedFile::close()
+{
+    if (m_data)
+        UnmapViewOfFile(m_data);
+    if (m_mapping)
+        CloseHandle(m_mapping);
+    if (m_file)
+        CloseHandle(m_file);
+
+    m_data = nullptr;
+    m_size = 0;
+    m_mapping = nullptr;
+    m_file = nullptr;
+}
+#else
+std::optional<std::string> MappedFile::open(const std::filesystem::path& path)
+{
+    std::optional<std::string> result;
+    close();
+
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        result.emplace(fmt::format("Unable to open {}", path.string()));
+        return result;
+    }
+
+    struct stat info { };
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        ::close(fd);
+        result.emplace(fmt::format("{} is empty", path.string()));
+        return result;
+    }
+
+    // The mapping keeps its own reference to the file
+    const auto size = static_cast<std::size_t>(info.st_size);
+    auto* view = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        result.emplace(fmt::format("Unable to map {}", path.string()));
+        return result;
+    }
+
+    madvise(view, size, MADV_SEQUENTIAL);
+    m_data = static_cast<const std::uint8_t*>(view);
+    m_size = size;
+    return result;
+}
+
+void MappedFile::close()
+{
+    if (m_data)
+        munmap(const_cast<std::uint8_t*>(m_data), m_size);
+
+    m_data = nullptr;
+    m_size = 0;
+}
+#endif
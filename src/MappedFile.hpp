@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+    // Map the file, replacing any previous mapping
+    [[nodiscard]] std::optional<std::string> open(const std::filesystem::path& path);
+    void close();
+
+    [[nodiscard]] auto data() const -> const std::uint8_t* { return m_data; }
+    [[nodiscard]] auto size() const -> std::size_t { return m_size; }
+
+private:
+    const std::uint8_t* m_data { nullptr };
+    std::size_t m_size { 0 };
+#ifdef _WIN32
+    void* m_file { nullptr };
+    void* m_mapping { nullptr };
+#endif
+};
@@ -0,0 +1,260 @@
+#include "ShaderComparison.hpp"
+#include "TextureManager.hpp"
+#include "Tracer.hpp"
+
+#include <SFML/Graphics/RectangleShape.hpp>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <imgui-SFML.h>
+#include <imgui.h>
+
+namespace {
+constexpr auto DIFFERENCE_SHADER_SOURCE = R"str(
+uniform sampler2D u_a;
+uniform sampler2D u_b;
+uniform vec2 u_resolution;
+uniform float u_gain;
+
+void main() {
+    vec2 st = gl_FragCoord.xy / u_resolution;
+    vec3 difference = abs(texture2D(u_a, st).rgb - texture2D(u_b, st).rgb) * u_gain;
+    gl_FragColor = vec4(difference, 1.0);
+})str";
+
+// Two sided 95% interval from the normal approximation, fine
+// once we've got more than a handful of frames
+constexpr double CONFIDENCE_Z { 1.96 };
+
+constexpr std::array SIDE_NAMES { "A", "B" };
+}
+
+ShaderComparison::ShaderComparison()
+{
+    for (auto& source : m_sources)
+        source.resize(constants::SOURCE_STRING_CHAR_COUNT);
+}
+
+bool ShaderComparison::create()
+{
+    return m_differenceShader.loadFromMemory(DIFFERENCE_SHADER_SOURCE, sf::Shader::Type::Fragment);
+}
+
+void ShaderComparison::compile(std::size_t side)
+{
+    const auto result = m_shaderMgrs[side].loadAndCompile(m_sources[side], m_useShadertoy[side]);
+    m_errors[side] = result.value_or("");
+
+    // An empty source "succeeds" without ever making a program
+    m_compiled[side] = !result && m_sources[side].find_first_not_of('\0') != std::string::npos;
+    resetStatistics();
+}
+
+void ShaderComparison::resetStatistics()
+{
+    // Anything still in flight was measured against the old setup,
+    // and the first frames after a compile tend to be outliers anyway
+    m_stats = {};
+    m_deltaHistory.clear();
+    m_samplesToSkip = WARMUP_SAMPLES;
+}
+
+void ShaderComparison::update(const ShaderManager::ShaderUniforms& uniforms, TextureManager& textureMgr)
+{
+    TRACE_SCOPE("ShaderComparison::update");
+    collectTimings();
+
+    const auto size = sf::Vector2u { uniforms.resolution };
+    if (m_difference.getSize() != size) {
+        m_failedToMakeTargets
+            = !m_targets[0].create(size) || !m_targets[1].create(size) || !m_difference.create(size);
+        resetStatistics();
+    }
+
+    if (m_failedToMakeTargets)
+        return;
+
+    m_uniforms = uniforms;
+
+    // Only time the frame if both sides have a program & both timers
+    // are free, so every measurement of A has a matching one of B and
+    // neither is just SFML drawing a flat quad
+    const bool timed = m_compiled[0] && m_compiled[1] && m_timers[0].canBegin() && m_timers[1].canBegin();
+    const std::size_t first = m_drawBFirst ? 1 : 0;
+    for (std::size_t i = 0; i < SIDE_COUNT; ++i) {
+        const auto side = (first + i) % SIDE_COUNT;
+        if (timed)
+            m_timers[side].begin();
+
+        renderSide(side, textureMgr);
+
+        if (timed)
+            m_timers[side].end();
+    }
+    m_drawBFirst = !m_drawBFirst;
+
+    m_differenceShader.setUniform("u_a", m_targets[0].getTexture());
+    m_differenceShader.setUniform("u_b", m_targets[1].getTexture());
+    m_differenceShader.setUniform("u_resolution", uniforms.resolution);
+    m_differenceShader.setUniform("u_gain", m_differenceGain);
+    m_difference.clear();
+    sf::RectangleShape shape(uniforms.resolution);
+    m_difference.draw(shape, &m_differenceShader);
+    m_difference.display();
+}
+
+void ShaderComparison::renderSide(std::size_t side, TextureManager& textureMgr)
+{
+    auto& shaderMgr = m_shaderMgrs[side];
+    shaderMgr.getUniforms() = m_uniforms;
+    shaderMgr.update(m_useShadertoy[side], textureMgr);
+
+    auto& target = m_targets[side];
+    target.clear();
+    sf::RectangleShape shape(sf::Vector2f { target.getSize() });
+    shape.setTextureRect({ { 0, 0 }, sf::Vector2i { shape.getSize() } });
+    target.draw(shape, &shaderMgr.getShader());
+    target.display();
+}
+
+void ShaderComparison::collectTimings()
+{
+    for (std::size_t side = 0; side < SIDE_COUNT; ++side) {
+        while (const auto gpuTime = m_timers[side].poll())
+            m_pendingCosts[side].push_back(static_cast<double>(gpuTime->asMicroseconds()) / 1000.0);
+    }
+
+    while (!m_pendingCosts[0].empty() && !m_pendingCosts[1].empty()) {
+        addSample(m_pendingCosts[0].front(), m_pendingCosts[1].front());
+        m_pendingCosts[0].pop_front();
+        m_pendingCosts[1].pop_front();
+    }
+}
+
+void ShaderComparison::addSample(double costA, double costB)
+{
+    if (m_samplesToSkip > 0) {
+        --m_samplesToSkip;
+        return;
+    }
+
+    // Welford's running mean & variance of the paired difference
+    const auto delta = costB - costA;
+    ++m_stats.count;
+    const auto count = static_cast<double>(m_stats.count);
+    m_stats.meanA += (costA - m_stats.meanA) / count;
+    m_stats.meanB += (costB - m_stats.meanB) / count;
+    const auto previousMean = m_stats.meanDelta;
+    m_stats.meanDelta += (delta - previousMean) / count;
+    m_stats.deltaM2 += (delta - previousMean) * (delta - m_stats.meanDelta);
+
+    m_deltaHistory.push_back(static_cast<float>(delta));
+    if (m_deltaHistory.size() > DELTA_HISTORY_COUNT)
+        m_deltaHistory.erase(m_deltaHistory.begin());
+}
+
+void ShaderComparison::drawUI(std::string_view editorSource, bool editorUsesShadertoy)
+{
+    ImGui::SetNextWindowSize({ 900, 650 }, ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("A/B Compare")) {
+        ImGui::End();
+        return;
+    }
+
+    /*
+    Sources
+    */
+    const auto spacing = ImGui::GetStyle().ItemSpacing.x;
+    const auto halfWidth = (ImGui::GetContentRegionAvail().x - spacing) * 0.5f;
+    for (std::size_t side = 0; side < SIDE_COUNT; ++side) {
+        ImGui::PushID(static_cast<int>(side));
+        if (side > 0)
+            ImGui::SameLine();
+
+        ImGui::BeginChild("##side", { halfWidth, 220 });
+        ImGui::Text("Shader %s", SIDE_NAMES[side]);
+        if (ImGui::Button("Copy From Editor")) {
+            m_sources[side] = editorSource;
+            m_sources[side].resize(constants::SOURCE_STRING_CHAR_COUNT);
+            m_useShadertoy[side] = editorUsesShadertoy;
+            compile(side);
+        }
+        ImGui::SameLine();
+        if (ImGui::Checkbox("Use Shadertoy Setup", &m_useShadertoy[side]))
+            compile(side);
+
+        if (ImGui::InputTextMultiline("##source",
+                                      m_sources[side].data(),
+                                      m_sources[side].size(),
+                                      { halfWidth, 150 },
+                                      ImGuiInputTextFlags_AllowTabInput))
+            compile(side);
+
+        if (!m_errors[side].empty())
+            ImGui::TextColored(ImVec4(sf::Color::Red), "%s", m_errors[side].data());
+        ImGui::EndChild();
+        ImGui::PopID();
+    }
+    ImGui::Separator();
+
+    /*
+    Images
+    */
+    if (m_failedToMakeTargets) {
+        ImGui::TextColored(ImVec4(sf::Color::Red), "Unable to create render textures");
+    } else {
+        const auto targetSize = sf::Vector2f { m_difference.getSize() };
+        const auto imageWidth = (ImGui::GetContentRegionAvail().x - 2.f * spacing) / 3.f;
+        const auto imageSize = sf::Vector2f { imageWidth, imageWidth * targetSize.y / std::max(targetSize.x, 1.f) };
+        ImGui::Text("A");
+        ImGui::SameLine(imageWidth + spacing);
+        ImGui::Text("B");
+        ImGui::SameLine(2.f * (imageWidth + spacing));
+        ImGui::Text("|A - B|");
+        ImGui::Image(m_targets[0], imageSize);
+        ImGui::SameLine();
+        ImGui::Image(m_targets[1], imageSize);
+        ImGui::SameLine();
+        ImGui::Image(m_difference, imageSize);
+        ImGui::SliderFloat("Difference Gain", &m_differenceGain, 1.f, 32.f, "%.1f");
+    }
+    ImGui::Separator();
+
+    /*
+    Timing
+    */
+    if (!m_timers[0].isSupported()) {
+        ImGui::Text("GPU timer queries aren't supported by this context");
+    } else if (!m_compiled[0] || !m_compiled[1]) {
+        ImGui::Text("Compile both sides to compare");
+    } else if (m_stats.count < 2) {
+        ImGui::Text("Collecting samples...");
+    } else {
+        const auto count = static_cast<double>(m_stats.count);
+        const auto standardDeviation = std::sqrt(m_stats.deltaM2 / (count - 1.0));
+        const auto interval = CONFIDENCE_Z * standardDeviation / std::sqrt(count);
+
+        ImGui::Text("A: %.4f ms    B: %.4f ms    (%zu frames)", m_stats.meanA, m_stats.meanB, m_stats.count);
+        ImGui::Text("B - A: %+.4f ms +/- %.4f ms (95%% CI)", m_stats.meanDelta, interval);
+        if (m_stats.meanDelta - interval > 0.0)
+            ImGui::Text("B is slower by %.1f%%", 100.0 * m_stats.meanDelta / std::max(m_stats.meanA, 1e-9));
+        else if (m_stats.meanDelta + interval < 0.0)
+            ImGui::Text("B is faster by %.1f%%", -100.0 * m_stats.meanDelta / std::max(m_stats.meanA, 1e-9));
+        else
+            ImGui::Text("No significant difference yet");
+
+        ImGui::PlotLines("B - A (ms)",
+                         m_deltaHistory.data(),
+                         static_cast<int>(m_deltaHistory.size()),
+                         0,
+                         nullptr,
+                         FLT_MAX,
+                         FLT_MAX,
+                         { 0, 60 });
+    }
+
+    if (ImGui::Button("Reset Statistics"))
+        resetStatistics();
+
+    ImGui::End();
+}
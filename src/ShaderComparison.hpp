@@ -0,0 +1,73 @@
+#pragma once
+
+#include "GpuTimer.hpp"
+#include "ShaderManager.hpp"
+
+#include <SFML/Graphics/RenderTexture.hpp>
+#include <SFML/Graphics/Shader.hpp>
+#include <array>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class TextureManager;
+
+// A/B mode: renders two shader sources with identical uniforms every
+// frame & compares what they cost on the GPU. The draw order flips each
+// frame so neither side always benefits from the other warming caches,
+// and the per-frame cost difference is tracked with a confidence interval.
+class ShaderComparison {
+public:
+    ShaderComparison();
+
+    // Compile the difference shader
+    [[nodiscard]] bool create();
+
+    // Render both sides & the difference image, uniforms.resolution
+    // decides the size of the render targets
+    void update(const ShaderManager::ShaderUniforms& uniforms, TextureManager& textureMgr);
+
+    // Draw the comparison window, the editor contents can be
+    // copied into either side
+    void drawUI(std::string_view editorSource, bool editorUsesShadertoy);
+
+private:
+    static constexpr std::size_t SIDE_COUNT { 2 };
+    static constexpr std::size_t DELTA_HISTORY_COUNT { 240 };
+    static constexpr std::size_t WARMUP_SAMPLES { 8 };
+
+    // Running statistics of the paired per-frame cost difference (B - A)
+    struct Statistics {
+        std::size_t count { 0 };
+        double meanA { 0.0 };
+        double meanB { 0.0 };
+        double meanDelta { 0.0 };
+        double deltaM2 { 0.0 };
+    };
+
+    void compile(std::size_t side);
+    void resetStatistics();
+    void collectTimings();
+    void addSample(double costA, double costB);
+    void renderSide(std::size_t side, TextureManager& textureMgr);
+
+    std::array<ShaderManager, SIDE_COUNT> m_shaderMgrs;
+    std::array<sf::RenderTexture, SIDE_COUNT> m_targets;
+    std::array<GpuTimer, SIDE_COUNT> m_timers;
+    std::array<std::deque<double>, SIDE_COUNT> m_pendingCosts;
+    std::array<std::string, SIDE_COUNT> m_sources;
+    std::array<std::string, SIDE_COUNT> m_errors;
+    std::array<bool, SIDE_COUNT> m_useShadertoy {};
+    std::array<bool, SIDE_COUNT> m_compiled {};
+    sf::RenderTexture m_difference;
+    sf::Shader m_differenceShader;
+    ShaderManager::ShaderUniforms m_uniforms;
+
+    Statistics m_stats;
+    std::vector<float> m_deltaHistory;
+    std::size_t m_samplesToSkip { 0 };
+    float m_differenceGain { 4.f };
+    bool m_drawBFirst { false };
+    bool m_failedToMakeTargets { false };
+};
@@ -0,0 +1,401 @@
+#include "ShaderGallery.hpp"
+#include "TextureManager.hpp"
+#include "Tracer.hpp"
+
+#include <SFML/Graphics/RectangleShape.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Window/Context.hpp>
+#include <algorithm>
+#include <fstream>
+#include <imgui-SFML.h>
+#include <imgui.h>
+#include <spdlog/fmt/fmt.h>
+#include <sstream>
+
+ShaderGallery::~ShaderGallery()
+{
+    stopScan();
+    stopCompiling();
+}
+
+bool ShaderGallery::create()
+{
+    if (!m_atlas.create({ ATLAS_SIZE, ATLAS_SIZE }) || !m_scratch.create({ THUMBNAIL_SIZE, THUMBNAIL_SIZE }))
+        return false;
+
+    m_atlas.clear();
+    m_atlas.display();
+    m_freeCells.clear();
+    for (std::size_t i = ATLAS_COLUMNS * ATLAS_COLUMNS; i > 0; --i)
+        m_freeCells.push_back(i - 1);
+
+    if (!m_compileThread.joinable())
+        m_compileThread = std::thread(&ShaderGallery::compileWorker, this);
+
+    return true;
+}
+
+void ShaderGallery::scanDirectory(const std::filesystem::path& directory)
+{
+    stopScan();
+
+    for (auto& entry : m_entries) {
+        if (entry.cell)
+            m_freeCells.push_back(entry.cell.value());
+    }
+    m_entries.clear();
+    m_compileCursor = 0;
+    m_queuedCompiles = 0;
+    m_renderCursor = 0;
+    ++m_generation;
+
+    {
+        std::lock_guard lock(m_compileMutex);
+        m_compileJobs.clear();
+        m_compileResults.clear();
+    }
+
+    {
+        std::lock_guard lock(m_scanMutex);
+        m_scanned.clear();
+        m_scanError.clear();
+    }
+
+    m_cancelScan = false;
+    m_scanning = true;
+    m_scanThread = std::thread(&ShaderGallery::scanWorker, this, directory);
+}
+
+void ShaderGallery::stopScan()
+{
+    m_cancelScan = true;
+    if (m_scanThread.joinable())
+        m_scanThread.join();
+    m_scanning = false;
+}
+
+void ShaderGallery::scanWorker(std::filesystem::path directory)
+{
+    TRACE_SCOPE("ShaderGallery::scanWorker");
+    std::error_code ec;
+    auto it = std::filesystem::directory_iterator(directory, ec);
+    if (ec) {
+        std::lock_guard lock(m_scanMutex);
+        m_scanError = fmt::format("Unable to open {}: {}", directory.string(), ec.message());
+        m_scanning = false;
+        return;
+    }
+
+    // Sorting keeps the grid stable between rescans
+    std::vector<std::filesystem::path> paths;
+    for (const auto& dirEntry : it) {
+        if (dirEntry.is_regular_file(ec) && ShaderManager::isShaderFile(dirEntry.path()))
+            paths.push_back(dirEntry.path());
+    }
+    std::sort(paths.begin(), paths.end());
+
+    for (const auto& path : paths) {
+        if (m_cancelScan)
+            break;
+
+        std::ifstream file(path);
+        if (!file)
+            continue;
+
+        std::stringstream contents;
+        contents << file.rdbuf();
+
+        std::lock_guard lock(m_scanMutex);
+        m_scanned.push_back({ path.filename().string(), contents.str() });
+    }
+
+    m_scanning = false;
+}
+
+std::optional<std::string> ShaderGallery::getScanError()
+{
+    std::optional<std::string> result;
+    std::lock_guard lock(m_scanMutex);
+    if (!m_scanError.empty())
+        result.emplace(m_scanError);
+
+    return result;
+}
+
+void ShaderGallery::update(const ShaderManager::ShaderUniforms& uniforms, TextureManager& textureMgr)
+{
+    drainScanned();
+    collectCompiled();
+    queueCompiles();
+    assignCells();
+    renderThumbnails(uniforms, textureMgr);
+
+    // drawUI() flags whatever is on screen again next frame
+    for (auto& entry : m_entries)
+        entry.visible = false;
+}
+
+void ShaderGallery::drainScanned()
+{
+    std::vector<ScannedShader> scanned;
+    {
+        std::lock_guard lock(m_scanMutex);
+        scanned.swap(m_scanned);
+    }
+
+    for (auto& shader : scanned) {
+        auto& entry = m_entries.emplace_back();
+        entry.name = std::move(shader.name);
+        entry.source = std::move(shader.source);
+        entry.useShadertoy = ShaderManager::isShadertoySource(entry.source);
+    }
+}
+
+void ShaderGallery::stopCompiling()
+{
+    {
+        std::lock_guard lock(m_compileMutex);
+        m_stopCompiling = true;
+    }
+    m_compileCondition.notify_one();
+    if (m_compileThread.joinable())
+        m_compileThread.join();
+}
+
+void ShaderGallery::compileWorker()
+{
+    trace::setThreadName("Gallery compiler");
+
+    // SFML shares every context it creates, so programs linked
+    // here can be drawn with from the main thread's context
+    sf::Context context;
+    std::unique_lock lock(m_compileMutex);
+    while (true) {
+        m_compileCondition.wait(lock, [this] { return m_stopCompiling || !m_compileJobs.empty(); });
+        if (m_stopCompiling)
+            break;
+
+        auto job = std::move(m_compileJobs.front());
+        m_compileJobs.pop_front();
+        lock.unlock();
+
+        auto shaderMgr = std::make_unique<ShaderManager>();
+        auto error = shaderMgr->loadAndCompile(job.source, job.useShadertoy);
+
+        lock.lock();
+        m_compileResults.push_back({ job.generation, job.index, std::move(shaderMgr), std::move(error) });
+    }
+}
+
+void ShaderGallery::collectCompiled()
+{
+    std::vector<CompileResult> results;
+    {
+        std::lock_guard lock(m_compileMutex);
+        results.swap(m_compileResults);
+    }
+
+    for (auto& result : results) {
+        if (result.generation != m_generation)
+            continue;
+
+        --m_queuedCompiles;
+        auto& entry = m_entries[result.index];
+        entry.shaderMgr = std::move(result.shaderMgr);
+        if (result.error) {
+            entry.state = EntryState::Failed;
+            entry.error = result.error.value();
+        } else {
+            entry.state = EntryState::Compiled;
+        }
+    }
+}
+
+void ShaderGallery::queueCompiles()
+{
+    // Only a few jobs are handed over at a time, so whatever
+    // scrolls into view doesn't wait behind a whole directory
+    bool queuedAny = false;
+    while (m_queuedCompiles < MAX_QUEUED_COMPILES) {
+        const auto index = nextToCompile();
+        if (!index)
+            break;
+
+        auto& entry = m_entries[index.value()];
+        entry.queued = true;
+        ++m_queuedCompiles;
+        queuedAny = true;
+
+        std::lock_guard lock(m_compileMutex);
+        m_compileJobs.push_back({ m_generation, index.value(), entry.source, entry.useShadertoy });
+    }
+
+    if (queuedAny)
+        m_compileCondition.notify_one();
+}
+
+std::optional<std::size_t> ShaderGallery::nextToCompile()
+{
+    std::optional<std::size_t> result;
+    const auto visible = std::find_if(
+        m_entries.begin(), m_entries.end(), [](const Entry& entry) { return entry.visible && !entry.queued; });
+    if (visible != m_entries.end()) {
+        result.emplace(static_cast<std::size_t>(visible - m_entries.begin()));
+        return result;
+    }
+
+    // Nothing on screen is waiting, so carry on through the
+    // rest in directory order
+    while (m_compileCursor < m_entries.size() && m_entries[m_compileCursor].queued)
+        ++m_compileCursor;
+
+    if (m_compileCursor < m_entries.size())
+        result.emplace(m_compileCursor);
+
+    return result;
+}
+
+void ShaderGallery::assignCells()
+{
+    for (auto& entry : m_entries) {
+        if (!entry.visible || entry.cell || entry.state != EntryState::Compiled)
+            continue;
+
+        if (m_freeCells.empty()) {
+            // Out of atlas space, take a cell from something off screen
+            const auto victim = std::find_if(m_entries.begin(), m_entries.end(), [](const Entry& other) {
+                return other.cell && !other.visible;
+            });
+            if (victim == m_entries.end())
+                return;
+
+            m_freeCells.push_back(victim->cell.value());
+            victim->cell.reset();
+            victim->rendered = false;
+        }
+
+        entry.cell = m_freeCells.back();
+        m_freeCells.pop_back();
+        entry.rendered = false;
+    }
+}
+
+void ShaderGallery::renderThumbnails(const ShaderManager::ShaderUniforms& uniforms, TextureManager& textureMgr)
+{
+    // Queries come back a few frames late, each one tells us
+    // what the batch recorded back then cost per thumbnail
+    while (const auto gpuTime = m_gpuTimer.poll()) {
+        if (m_timedBatchSizes.empty())
+            break;
+
+        const auto batchSize = static_cast<float>(m_timedBatchSizes.front());
+        m_timedBatchSizes.erase(m_timedBatchSizes.begin());
+        const auto cost = gpuTime->asSeconds() * 1000.f / batchSize;
+        m_thumbnailCostMs = 0.8f * m_thumbnailCostMs + 0.2f * cost;
+    }
+
+    if (m_entries.empty())
+        return;
+
+    const auto affordable = static_cast<std::size_t>(THUMBNAIL_BUDGET_MS / std::max(m_thumbnailCostMs, 0.01f));
+    const auto budget = std::clamp(affordable, std::size_t { 1 }, MAX_THUMBNAILS_PER_FRAME);
+
+    // Round robin over the visible thumbnails so each one
+    // gets refreshed at a rate that degrades evenly
+    std::vector<std::size_t> batch;
+    for (std::size_t checked = 0; checked < m_entries.size() && batch.size() < budget; ++checked) {
+        const auto index = (m_renderCursor + checked) % m_entries.size();
+        const auto& entry = m_entries[index];
+        if (entry.visible && entry.cell && entry.state == EntryState::Compiled)
+            batch.push_back(index);
+    }
+
+    if (batch.empty())
+        return;
+
+    m_renderCursor = (batch.back() + 1) % m_entries.size();
+
+    const bool timed = m_gpuTimer.begin();
+    for (const auto index : batch)
+        renderThumbnail(m_entries[index], uniforms, textureMgr);
+    m_atlas.display();
+
+    if (timed) {
+        m_gpuTimer.end();
+        m_timedBatchSizes.push_back(batch.size());
+    }
+}
+
+void ShaderGallery::renderThumbnail(Entry& entry,
+                                    const ShaderManager::ShaderUniforms& uniforms,
+                                    TextureManager& textureMgr)
+{
+    // Shaders mostly work off gl_FragCoord, so render at the origin of a
+    // scratch target first rather than straight into the atlas cell
+    const auto thumbnailSize = sf::Vector2f { static_cast<float>(THUMBNAIL_SIZE), static_cast<float>(THUMBNAIL_SIZE) };
+    auto& thumbnailUniforms = entry.shaderMgr->getUniforms();
+    thumbnailUniforms = uniforms;
+    thumbnailUniforms.resolution = thumbnailSize;
+    thumbnailUniforms.mousePos = thumbnailSize * 0.5f;
+    entry.shaderMgr->update(entry.useShadertoy, textureMgr);
+
+    m_scratch.clear();
+    sf::RectangleShape shape(thumbnailSize);
+    shape.setTextureRect({ { 0, 0 }, sf::Vector2i { shape.getSize() } });
+    m_scratch.draw(shape, &entry.shaderMgr->getShader());
+    m_scratch.display();
+
+    const auto cell = entry.cell.value();
+    sf::Sprite spr(m_scratch.getTexture());
+    spr.setPosition({ static_cast<float>(cell % ATLAS_COLUMNS) * thumbnailSize.x,
+                      static_cast<float>(cell / ATLAS_COLUMNS) * thumbnailSize.y });
+    m_atlas.draw(spr);
+    entry.rendered = true;
+}
+
+const ShaderGallery::Entry* ShaderGallery::drawUI()
+{
+    constexpr auto DISPLAY_SIZE { 96.f };
+    const Entry* clicked = nullptr;
+
+    const auto spacing = ImGui::GetStyle().ItemSpacing.x;
+    const auto columns
+        = std::max(1, static_cast<int>((ImGui::GetContentRegionAvail().x + spacing) / (DISPLAY_SIZE + spacing)));
+
+    for (std::size_t i = 0; i < m_entries.size(); ++i) {
+        auto& entry = m_entries[i];
+        ImGui::PushID(static_cast<int>(i));
+        if (i % static_cast<std::size_t>(columns) != 0)
+            ImGui::SameLine();
+
+        bool pressed = false;
+        if (entry.cell && entry.rendered) {
+            // Render textures are stored upside down, so flip the
+            // cell's texture rect when handing it to imgui
+            const auto cell = static_cast<int>(entry.cell.value());
+            const auto size = static_cast<int>(THUMBNAIL_SIZE);
+            const auto columnCount = static_cast<int>(ATLAS_COLUMNS);
+            const auto flippedTop = static_cast<int>(ATLAS_SIZE) - (cell / columnCount) * size;
+            sf::Sprite spr(m_atlas.getTexture());
+            spr.setTextureRect({ { (cell % columnCount) * size, flippedTop }, { size, -size } });
+            pressed = ImGui::ImageButton(spr, { DISPLAY_SIZE, DISPLAY_SIZE }, 0);
+        } else {
+            const auto* label = entry.state == EntryState::Failed ? "Error" : "...";
+            pressed = ImGui::Button(label, { DISPLAY_SIZE, DISPLAY_SIZE });
+        }
+
+        entry.visible = ImGui::IsItemVisible();
+        if (ImGui::IsItemHovered()) {
+            if (entry.state == EntryState::Failed)
+                ImGui::SetTooltip("%s\n%s", entry.name.data(), entry.error.data());
+            else
+                ImGui::SetTooltip("%s", entry.name.data());
+        }
+
+        if (pressed)
+            clicked = &entry;
+        ImGui::PopID();
+    }
+
+    return clicked;
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "GpuTimer.hpp"
+#include "ShaderManager.hpp"
+
+#include <SFML/Graphics/RenderTexture.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+class TextureManager;
+
+// Browses a directory of fragment shaders & keeps live thumbnails of
+// them in a single atlas texture. Files are read on a worker thread and
+// compiled on another with its own shared context, visible ones first.
+// Only thumbnails that were on screen last frame get re-rendered, within
+// a small GPU time budget.
+class ShaderGallery {
+public:
+    enum class EntryState { Pending, Compiled, Failed };
+
+    struct Entry {
+        std::string name;
+        std::string source;
+        std::string error;
+        std::unique_ptr<ShaderManager> shaderMgr;
+        std::optional<std::size_t> cell;
+        EntryState state { EntryState::Pending };
+        bool useShadertoy { false };
+        bool queued { false };
+        bool visible { false };
+        bool rendered { false };
+    };
+
+    ShaderGallery() = default;
+    ~ShaderGallery();
+
+    // Create the atlas & scratch render textures, and
+    // start the compile thread
+    [[nodiscard]] bool create();
+
+    // Drop the current entries & start loading every shader in the
+    // directory on a worker thread
+    void scanDirectory(const std::filesystem::path& directory);
+
+    // Queue & collect compiles, then refresh visible thumbnails
+    void update(const ShaderManager::ShaderUniforms& uniforms, TextureManager& textureMgr);
+
+    // Draw the thumbnail grid into the current imgui window,
+    // returns the entry that was clicked if any
+    [[nodiscard]] const Entry* drawUI();
+
+    [[nodiscard]] auto isScanning() const -> bool { return m_scanning; }
+    [[nodiscard]] auto getEntryCount() const -> std::size_t { return m_entries.size(); }
+    [[nodiscard]] std::optional<std::string> getScanError();
+
+private:
+    struct ScannedShader {
+        std::string name;
+        std::string source;
+    };
+
+    // Jobs & results carry the scan generation they were queued
+    // in, so anything from before a rescan can be thrown away
+    struct CompileJob {
+        std::size_t generation { 0 };
+        std::size_t index { 0 };
+        std::string source;
+        bool useShadertoy { false };
+    };
+
+    struct CompileResult {
+        std::size_t generation { 0 };
+        std::size_t index { 0 };
+        std::unique_ptr<ShaderManager> shaderMgr;
+        std::optional<std::string> error;
+    };
+
+    static constexpr unsigned ATLAS_SIZE { 1024 };
+    static constexpr unsigned THUMBNAIL_SIZE { 128 };
+    static constexpr std::size_t ATLAS_COLUMNS { ATLAS_SIZE / THUMBNAIL_SIZE };
+    static constexpr std::size_t MAX_QUEUED_COMPILES { 4 };
+    static constexpr std::size_t MAX_THUMBNAILS_PER_FRAME { 8 };
+    static constexpr float THUMBNAIL_BUDGET_MS { 2.f };
+
+    void stopScan();
+    void scanWorker(std::filesystem::path directory);
+    void drainScanned();
+    void stopCompiling();
+    void compileWorker();
+    void collectCompiled();
+    void queueCompiles();
+    [[nodiscard]] std::optional<std::size_t> nextToCompile();
+    void assignCells();
+    void renderThumbnails(const ShaderManager::ShaderUniforms& uniforms, TextureManager& textureMgr);
+    void renderThumbnail(Entry& entry, const ShaderManager::ShaderUniforms& uniforms, TextureManager& textureMgr);
+
+    sf::RenderTexture m_atlas;
+    sf::RenderTexture m_scratch;
+    GpuTimer m_gpuTimer;
+    std::vector<Entry> m_entries;
+    std::vector<std::size_t> m_freeCells;
+    std::vector<std::size_t> m_timedBatchSizes;
+    std::size_t m_compileCursor { 0 };
+    std::size_t m_queuedCompiles { 0 };
+    std::size_t m_generation { 0 };
+    std::size_t m_renderCursor { 0 };
+    float m_thumbnailCostMs { 0.25f };
+
+    std::thread m_scanThread;
+    std::mutex m_scanMutex;
+    std::vector<ScannedShader> m_scanned;
+    std::string m_scanError;
+    std::atomic<bool> m_scanning { false };
+    std::atomic<bool> m_cancelScan { false };
+
+    std::thread m_compileThread;
+    std::mutex m_compileMutex;
+    std::condition_variable m_compileCondition;
+    std::deque<CompileJob> m_compileJobs;
+    std::vector<CompileResult> m_compileResults;
+    bool m_stopCompiling { false };
+};
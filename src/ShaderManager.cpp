@@ -1,9 +1,15 @@
 #include "ShaderManager.hpp"
+#include "ErrorCapture.hpp"
 #include "TextureManager.hpp"
+#include "Tracer.hpp"
 
-#include <SFML/System/Err.hpp>
+#include <algorithm>
+#include <array>
 #include <spdlog/fmt/fmt.h>
-#include <sstream>
+
+namespace {
+constexpr std::array SHADER_EXTENSIONS { ".fs", ".frag", ".glsl" };
+}
 
 ShaderManager::ShaderManager() { }
 
@@ -35,7 +41,7 @@ void ShaderManager::update(bool useShadertoy, TextureManager& textureMgr)
         for (std::size_t i = 0; i < constants::TEXTURE_CHANNELS_COUNT; ++i) {
             if (textureMgr.getTexture(i)) {
                 auto var = fmt::format("iChannel{}", i);
-                m_shader.setUniform(var, textureMgr.getTexture(i));
+                m_shader.setUniform(var, *textureMgr.getTexture(i));
             }
         }
     }
@@ -43,6 +49,7 @@ void ShaderManager::update(bool useShadertoy, TextureManager& textureMgr)
 
 std::optional<std::string> ShaderManager::loadAndCompile(std::string_view source, bool useShadertoy)
 {
+    TRACE_SCOPE("ShaderManager::loadAndCompile");
     std::optional<std::string> result;
     bool foundChar = false;
     for (auto& c : source) {
@@ -62,9 +69,7 @@ std::optional<std::string> ShaderManager::loadAndCompile(std::string_view source
     // Redirect the error stream
     // so we can log the shader errors
     // to an imgui window
-    auto defaultStr = sf::err().rdbuf();
-    std::stringstream errStream;
-    sf::err().rdbuf(errStream.rdbuf());
+    ErrorCapture errCapture;
 
     // We need to append on the uniforms as
     // string depending on whether or not
@@ -79,13 +84,21 @@ std::optional<std::string> ShaderManager::loadAndCompile(std::string_view source
     // Let's compile the shader, if it failed
     // then we should mark a flag saying it failed
     if (!m_shader.loadFromMemory(combined, sf::Shader::Type::Fragment)) {
-        result.emplace(errStream.str());
+        result.emplace(errCapture.str());
         m_didFailLastCompile = true;
     } else
         m_didFailLastCompile = false;
 
-    // Redirect the error stream
-    // back to its default state!
-    sf::err().rdbuf(defaultStr);
     return result;
 }
+
+bool ShaderManager::isShadertoySource(std::string_view source)
+{
+    return source.find("mainImage") != std::string_view::npos;
+}
+
+bool ShaderManager::isShaderFile(const std::filesystem::path& path)
+{
+    const auto extension = path.extension().string();
+    return std::find(SHADER_EXTENSIONS.begin(), SHADER_EXTENSIONS.end(), extension) != SHADER_EXTENSIONS.end();
+}
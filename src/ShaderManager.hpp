@@ -6,6 +6,7 @@
 #include <SFML/Graphics/Texture.hpp>
 #include <SFML/System/Time.hpp>
 #include <array>
+#include <filesystem>
 #include <optional>
 #include <string>
 
@@ -29,6 +30,12 @@ public:
     [[nodiscard]] auto getShader() -> sf::Shader& { return m_shader; }
     [[nodiscard]] auto didFailLastCompilation() const -> bool { return m_didFailLastCompile; }
 
+    // Shadertoy sources provide mainImage() rather than main()
+    [[nodiscard]] static bool isShadertoySource(std::string_view source);
+
+    // Whether the file extension is one we treat as a fragment shader
+    [[nodiscard]] static bool isShaderFile(const std::filesystem::path& path);
+
 private:
     const std::string m_defaultUniformNames = R"str(
             uniform vec2 u_resolution; 
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Fixed capacity lock-free queue for exactly one producer thread
+// and one consumer thread. Never allocates after construction, so
+// it's safe to push from audio callbacks & similar.
+template <typename T, std::size_t Capacity>
+class SpscRing {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // Producer side, returns false (dropping the value) when full
+    bool tryPush(const T& value)
+    {
+        const auto tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == Capacity)
+            return false;
+
+        m_slots[tail & (Capacity - 1)] = value;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side, returns false when empty
+    bool tryPop(T& value)
+    {
+        const auto head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire))
+            return false;
+
+        value = m_slots[head & (Capacity - 1)];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::array<T, Capacity> m_slots {};
+    alignas(64) std::atomic<std::size_t> m_head { 0 };
+    alignas(64) std::atomic<std::size_t> m_tail { 0 };
+};
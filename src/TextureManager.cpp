@@ -1,36 +1,62 @@
 #include "TextureManager.hpp"
+#include "ErrorCapture.hpp"
+#include "Tracer.hpp"
 
-#include <SFML/System/Err.hpp>
 #include <cassert>
+#include <filesystem>
 #include <spdlog/spdlog.h>
-#include <sstream>
 
 std::optional<std::string> TextureManager::setPathAndLoad(std::size_t textureIndex, std::string_view path)
 {
+    TRACE_SCOPE("TextureManager::setPathAndLoad");
     std::optional<std::string> result;
+
+    // Paths typically come straight from a fixed size ImGui buffer,
+    // so anything after the first NUL is padding rather than path
+    path = path.substr(0, path.find('\0'));
     if (path.empty())
         return result;
 
     m_textureUniforms[textureIndex].path = path;
     assert(textureIndex < m_textureUniforms.size());
+    m_textureUniforms[textureIndex].data.reset();
+    m_textureUniforms[textureIndex].audio.reset();
+
+    // Audio sources & raw data arrays aren't images (or even files
+    // in the case of capture devices), so check for those first
+    if (AudioChannel::isAudioPath(path)) {
+        auto audio = std::make_unique<AudioChannel>();
+        result = audio->open(path);
+        m_textureUniforms[textureIndex].loaded = !result;
+        if (!result)
+            m_textureUniforms[textureIndex].audio = std::move(audio);
+        return result;
+    }
+
+    if (DataChannel::isDataPath(path)) {
+        auto data = std::make_unique<DataChannel>();
+        result = data->open(path);
+        m_textureUniforms[textureIndex].loaded = !result;
+        if (!result)
+            m_textureUniforms[textureIndex].data = std::move(data);
+        return result;
+    }
+
     if (!std::filesystem::exists(path)) {
         m_textureUniforms[textureIndex].loaded = false;
-        result.emplace(fmt::format("Texture {} not found", path.data()));
+        result.emplace(fmt::format("Texture {} not found", path));
         return result;
     }
 
-    auto defaultStr = sf::err().rdbuf();
-    std::stringstream errStream;
-    sf::err().rdbuf(errStream.rdbuf());
-    if (!m_textureUniforms[textureIndex].texture.loadFromFile(path.data())) {
+    ErrorCapture errCapture;
+    if (!m_textureUniforms[textureIndex].texture.loadFromFile(m_textureUniforms[textureIndex].path)) {
         // TODO: somehow display an error about this...?
         m_textureUniforms[textureIndex].loaded = false;
-        result.emplace(errStream.str());
+        result.emplace(errCapture.str());
     } else {
         m_textureUniforms[textureIndex].loaded = true;
     }
 
-    sf::err().rdbuf(defaultStr);
     return result;
 }
 
@@ -41,9 +67,27 @@ sf::Texture* TextureManager::getTexture(std::size_t textureIndex)
     if (!m_textureUniforms[textureIndex].loaded) {
         return nullptr;
     }
+
+    if (m_textureUniforms[textureIndex].data)
+        return &m_textureUniforms[textureIndex].data->getTexture();
+
+    if (m_textureUniforms[textureIndex].audio)
+        return &m_textureUniforms[textureIndex].audio->getTexture();
+
     return &m_textureUniforms[textureIndex].texture;
 }
 
+void TextureManager::update(std::int32_t frames)
+{
+    for (auto& entry : m_textureUniforms) {
+        if (entry.data)
+            entry.data->update(frames);
+
+        if (entry.audio)
+            entry.audio->update();
+    }
+}
+
 std::string TextureManager::getTexturePath(std::size_t textureIndex) const
 {
     assert(textureIndex < m_textureUniforms.size());
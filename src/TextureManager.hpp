@@ -1,9 +1,12 @@
 #pragma once
 
+#include "AudioChannel.hpp"
 #include "Constants.hpp"
+#include "DataChannel.hpp"
 
 #include <SFML/Graphics/Texture.hpp>
 #include <array>
+#include <memory>
 #include <optional>
 #include <string>
 
@@ -11,6 +14,8 @@ class TextureManager {
 public:
     struct TextureEntry {
         sf::Texture texture;
+        std::unique_ptr<DataChannel> data;
+        std::unique_ptr<AudioChannel> audio;
         std::string path;
         bool loaded { false };
     };
@@ -18,6 +23,9 @@ public:
     // Set the path of the texture & then attempt to load it
     [[nodiscard]] std::optional<std::string> setPathAndLoad(std::size_t textureIndex, std::string_view path);
 
+    // Advance any channels that change over time
+    void update(std::int32_t frames);
+
     [[nodiscard]] sf::Texture* getTexture(std::size_t textureIndex);
 
     [[nodiscard]] std::string getTexturePath(std::size_t textureIndex) const;
@@ -0,0 +1,159 @@
+#include "Tracer.hpp"
+#include "SpscRing.hpp"
+
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <spdlog/fmt/fmt.h>
+#include <string_view>
+#include <vector>
+
+namespace {
+constexpr std::size_t RING_CAPACITY { 4096 };
+constexpr std::size_t HISTORY_CAPACITY { 1 << 17 };
+
+struct ThreadBuffer {
+    SpscRing<trace::Event, RING_CAPACITY> ring;
+    std::uint32_t id { 0 };
+};
+
+struct CollectedEvent {
+    trace::Event event;
+    std::uint32_t threadId { 0 };
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::map<std::uint32_t, std::string> threadNames;
+    std::deque<CollectedEvent> history;
+    std::uint32_t nextThreadId { 1 };
+};
+
+Registry& getRegistry()
+{
+    static Registry registry;
+    return registry;
+}
+
+// Registered on the first span a thread records. The registry keeps
+// its own reference so events outlive the thread until collected.
+ThreadBuffer& getThreadBuffer()
+{
+    thread_local const auto buffer = [] {
+        auto& registry = getRegistry();
+        auto newBuffer = std::make_shared<ThreadBuffer>();
+        std::lock_guard lock(registry.mutex);
+        newBuffer->id = registry.nextThreadId++;
+        registry.buffers.push_back(newBuffer);
+        return newBuffer;
+    }();
+    return *buffer;
+}
+
+std::string escape(std::string_view str)
+{
+    std::string result;
+    for (const auto c : str) {
+        if (c == '"' || c == '\\')
+            result += '\\';
+        result += c;
+    }
+    return result;
+}
+}
+
+namespace trace {
+void setEnabled(bool enabled) { detail::enabled.store(enabled, std::memory_order_relaxed); }
+
+std::uint64_t now()
+{
+    static const auto start = std::chrono::steady_clock::now();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+void setThreadName(std::string name)
+{
+    const auto id = getThreadBuffer().id;
+    auto& registry = getRegistry();
+    std::lock_guard lock(registry.mutex);
+    registry.threadNames[id] = std::move(name);
+}
+
+void record(const char* name, std::uint64_t startNs, std::uint64_t durationNs)
+{
+    // A full ring means collect() isn't keeping up, losing
+    // the span beats blocking the thread being traced
+    getThreadBuffer().ring.tryPush({ name, startNs, durationNs });
+}
+
+void collect()
+{
+    auto& registry = getRegistry();
+    std::lock_guard lock(registry.mutex);
+    for (auto it = registry.buffers.begin(); it != registry.buffers.end();) {
+        auto& buffer = **it;
+        Event event;
+        while (buffer.ring.tryPop(event))
+            registry.history.push_back({ event, buffer.id });
+
+        // Only we hold a reference once the thread has exited
+        if (it->use_count() == 1)
+            it = registry.buffers.erase(it);
+        else
+            ++it;
+    }
+
+    while (registry.history.size() > HISTORY_CAPACITY)
+        registry.history.pop_front();
+}
+
+std::optional<std::string> dump(const std::filesystem::path& path)
+{
+    std::optional<std::string> result;
+    std::vector<CollectedEvent> events;
+    std::map<std::uint32_t, std::string> threadNames;
+    {
+        auto& registry = getRegistry();
+        std::lock_guard lock(registry.mutex);
+        events.assign(registry.history.begin(), registry.history.end());
+        threadNames = registry.threadNames;
+    }
+
+    std::ofstream file(path);
+    if (!file) {
+        result.emplace(fmt::format("Unable to write trace to {}", path.string()));
+        return result;
+    }
+
+    file << R"({"displayTimeUnit":"ns","traceEvents":[)" << '\n';
+    bool first = true;
+    for (const auto& [id, name] : threadNames) {
+        file << (first ? "" : ",\n")
+             << fmt::format(R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},"args":{{"name":"{}"}}}})",
+                            id,
+                            escape(name));
+        first = false;
+    }
+
+    for (const auto& [event, threadId] : events) {
+        file << (first ? "" : ",\n")
+             << fmt::format(R"({{"name":"{}","ph":"X","pid":1,"tid":{},"ts":{:.3f},"dur":{:.3f}}})",
+                            escape(event.name),
+                            threadId,
+                            static_cast<double>(event.startNs) / 1000.0,
+                            static_cast<double>(event.durationNs) / 1000.0);
+        first = false;
+    }
+    file << "\n]}\n";
+
+    if (!file)
+        result.emplace(fmt::format("Failed writing trace to {}", path.string()));
+
+    return result;
+}
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+// Scoped span tracing. Each thread records into its own lock-free ring,
+// the main thread gathers them once per frame with collect(), and dump()
+// writes the recent history as Chrome trace event JSON (load it in
+// ui.perfetto.dev or chrome://tracing). While disabled a span costs a
+// single relaxed atomic load.
+namespace trace {
+struct Event {
+    const char* name { nullptr };
+    std::uint64_t startNs { 0 };
+    std::uint64_t durationNs { 0 };
+};
+
+namespace detail {
+    inline std::atomic<bool> enabled { false };
+}
+
+[[nodiscard]] inline bool isEnabled() { return detail::enabled.load(std::memory_order_relaxed); }
+void setEnabled(bool enabled);
+
+// Nanoseconds since the first call
+[[nodiscard]] std::uint64_t now();
+
+// Name shown for the calling thread in the trace viewer
+void setThreadName(std::string name);
+
+// Span names must be string literals, only the pointer is stored
+void record(const char* name, std::uint64_t startNs, std::uint64_t durationNs);
+
+// Move every thread's events into the history dump() writes out
+void collect();
+
+[[nodiscard]] std::optional<std::string> dump(const std::filesystem::path& path);
+
+class Span {
+public:
+    explicit Span(const char* name)
+        : m_name(isEnabled() ? name : nullptr)
+        , m_start(m_name ? now() : 0)
+    {
+    }
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+    ~Span()
+    {
+        if (m_name)
+            record(m_name, m_start, now() - m_start);
+    }
+
+private:
+    const char* m_name;
+    std::uint64_t m_start;
+};
+}
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+#define TRACE_SCOPE(name) const trace::Span TRACE_CONCAT(traceSpan, __LINE__) { name }
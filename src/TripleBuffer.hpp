@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Lock-free latest value hand-off between exactly one producer thread
+// and one consumer thread. The producer never waits & never has its
+// newest value dropped, the consumer always reads the most recently
+// published one and skips anything it was too slow to see.
+template <typename T>
+class TripleBuffer {
+public:
+    // Producer side, fill this in & then publish() it
+    [[nodiscard]] T& back() { return m_slots[m_back]; }
+
+    void publish()
+    {
+        const auto previous = m_middle.exchange(m_back | FRESH_BIT, std::memory_order_acq_rel);
+        m_back = previous & INDEX_MASK;
+    }
+
+    // Consumer side, returns false if nothing was published since the last read
+    bool tryRead(T& value)
+    {
+        if (!(m_middle.load(std::memory_order_relaxed) & FRESH_BIT))
+            return false;
+
+        const auto previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = previous & INDEX_MASK;
+        value = m_slots[m_front];
+        return true;
+    }
+
+private:
+    static constexpr std::uint8_t INDEX_MASK { 0x3 };
+    static constexpr std::uint8_t FRESH_BIT { 0x4 };
+
+    std::array<T, 3> m_slots {};
+    alignas(64) std::uint8_t m_back { 0 };
+    alignas(64) std::atomic<std::uint8_t> m_middle { 1 };
+    alignas(64) std::uint8_t m_front { 2 };
+};